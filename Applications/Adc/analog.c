@@ -31,6 +31,7 @@ https://en.wikipedia.org/wiki/BSD_licenses#0-clause_license_(%22Zero_Clause_BSD%
 #include "../lib/twi0_bsd.h"
 #include "../lib/timers_bsd.h"
 #include "../lib/uart0_bsd.h"
+#include "../lib/fixed_point.h"
 #include "analog.h"
 #include "references.h"
 
@@ -42,6 +43,27 @@ static uint8_t adc_ch_from_manager;
 static int temp_adc;
 static float temp_ref_extern_avcc;
 static float temp_ch_calibration_value;
+static char fixed_buf[FIXED_STR_SIZE];
+
+// manager reference and channel calibrations are kept until the manager analog generation changes
+#define CACHE_REF_VALID 0x80
+static uint8_t cache_valid; // bit n for ADC_CH_MGR channel n calibration, CACHE_REF_VALID for extern_avcc
+static uint8_t cache_generation = MGR_ANALOG_GEN_NONE;
+static float cache_ref_extern_avcc;
+static float cache_ch_calibration[ADC_CH_MGR_MAX_NOT_A_CH];
+
+// microvolts at the ADC input, adc*ref/1024 split so it does not overflow 32 bits
+static int32_t adc_to_uV(int adc, uint32_t ref_uV)
+{
+    uint32_t uV = ((uint32_t)adc * (ref_uV >> 10)) + (((uint32_t)adc * (ref_uV & 0x3FF)) >> 10);
+    return (int32_t) uV;
+}
+
+// the manager values are floats, scale the reading to micro units (uV or uA) with one multiply
+static int32_t mgr_to_micro(int adc, float ref, float calibration)
+{
+    return (int32_t) (adc * ref * calibration * 1.0E6 + 0.5);
+}
 
 // use a state machine to restore where the twi transaction is at 
 static TWI0_LOOP_STATE_t twi0_loop_state = TWI0_LOOP_STATE_DONE;
@@ -136,8 +158,28 @@ void Analog(unsigned long serial_print_delay_milsec)
                 initCommandBuffer();
                 return;
             }
-            twi0_loop_state = TWI0_LOOP_STATE_INIT; // manager also has referance, set init twi state for next step
-            command_done = 13;
+            if ( (mgr_analog_generation == MGR_ANALOG_GEN_NONE) || (mgr_analog_generation != cache_generation) )
+            {
+                cache_valid = 0;
+                cache_generation = mgr_analog_generation;
+            }
+            if (cache_valid & (1<<adc_ch_from_manager))
+            {
+                temp_ref_extern_avcc = cache_ref_extern_avcc;
+                temp_ch_calibration_value = cache_ch_calibration[adc_ch_from_manager];
+                command_done = 20;
+            }
+            else if (cache_valid & CACHE_REF_VALID)
+            {
+                temp_ref_extern_avcc = cache_ref_extern_avcc;
+                twi0_loop_state = TWI0_LOOP_STATE_INIT; // manager has the callibraion, set init twi state for next step
+                command_done = 14;
+            }
+            else
+            {
+                twi0_loop_state = TWI0_LOOP_STATE_INIT; // manager also has referance, set init twi state for next step
+                command_done = 13;
+            }
         }
     }
     else if ( (command_done == 13) )
@@ -155,6 +197,8 @@ void Analog(unsigned long serial_print_delay_milsec)
                 return;
             }
             temp_ref_extern_avcc = temp_float;
+            cache_ref_extern_avcc = temp_float;
+            cache_valid |= CACHE_REF_VALID;
             twi0_loop_state = TWI0_LOOP_STATE_INIT; // manager also has a callibraion, set init twi state for next step
             command_done = 14;
         }
@@ -174,6 +218,8 @@ void Analog(unsigned long serial_print_delay_milsec)
                 return;
             }
             temp_ch_calibration_value = temp_float;
+            cache_ch_calibration[adc_ch_from_manager] = temp_float;
+            cache_valid |= (1<<adc_ch_from_manager);
             command_done = 20;
         }
     }
@@ -194,24 +240,24 @@ void Analog(unsigned long serial_print_delay_milsec)
             case ADC_CH_ADC5:
             case ADC_CH_ADC6:
             case ADC_CH_ADC7:
-                printf_P(PSTR("\"%1.2f\""),(temp_adc*(ref_extern_avcc_uV/1.0E6)/1024.0));
+                printf_P(PSTR("\"%s\""), fixed_to_str(fixed_buf, adc_to_uV(temp_adc, ref_extern_avcc_uV), 6, 2) );
                 break;
 
             case (ADC_CHANNELS + ADC_CH_MGR_ALT_I): //was ADC5 on ^0, now it is on the manager ADC at channel 0
                 // printf_P(PSTR("\"%1.3f\""),(temp_adc*((ref_extern_avcc_uV/1.0E6)/1024.0)/(0.018*50.0)));
-                printf_P(PSTR("\"%1.2f\""), (temp_adc*temp_ref_extern_avcc*temp_ch_calibration_value) );
+                printf_P(PSTR("\"%s\""), fixed_to_str(fixed_buf, mgr_to_micro(temp_adc, temp_ref_extern_avcc, temp_ch_calibration_value), 6, 2) );
                 break;
             case (ADC_CHANNELS + ADC_CH_MGR_ALT_V): //was ADC4 on ^0, now it is on the manager ADC at channel 1
                 // printf_P(PSTR("\"%1.2f\""),(temp_adc*((5.0)*(110.0/10.0)/1024.0));
-                printf_P(PSTR("\"%1.2f\""), (temp_adc*temp_ref_extern_avcc*temp_ch_calibration_value) );
+                printf_P(PSTR("\"%s\""), fixed_to_str(fixed_buf, mgr_to_micro(temp_adc, temp_ref_extern_avcc, temp_ch_calibration_value), 6, 2) );
                 break;
             case (ADC_CHANNELS + ADC_CH_MGR_PWR_I): //was ADC6 on ^0, now it is on the manager ADC at channel 6
                 // printf_P(PSTR("\"%1.3f\""),(temp_adc*((ref_extern_avcc_uV/1.0E6)/1024.0)/(0.068*50.0)));
-                printf_P(PSTR("\"%1.2f\""), (temp_adc*temp_ref_extern_avcc*temp_ch_calibration_value) );
+                printf_P(PSTR("\"%s\""), fixed_to_str(fixed_buf, mgr_to_micro(temp_adc, temp_ref_extern_avcc, temp_ch_calibration_value), 6, 2) );
                 break;
             case (ADC_CHANNELS + ADC_CH_MGR_PWR_V): //was ADC7 on ^0, now it is on the manager ADC at channel 7
                 // printf_P(PSTR("\"%1.2f\""),(temp_adc*((ref_extern_avcc_uV/1.0E6)/1024.0)*(115.8/15.8)));
-                printf_P(PSTR("\"%1.2f\""), (temp_adc*temp_ref_extern_avcc*temp_ch_calibration_value) );
+                printf_P(PSTR("\"%s\""), fixed_to_str(fixed_buf, mgr_to_micro(temp_adc, temp_ref_extern_avcc, temp_ch_calibration_value), 6, 2) );
                 break;
 
             default:
@@ -24,9 +24,12 @@ https://en.wikipedia.org/wiki/BSD_licenses#0-clause_license_(%22Zero_Clause_BSD%
 #include <stdlib.h>
 #include <ctype.h>
 #include "../lib/parse.h"
+#include "../lib/fixed_point.h"
 #include "references.h"
 #include "calibrate.h"
 
+static char fixed_buf[FIXED_STR_SIZE];
+
 // arg[0] is external voltage on AVCC pin in microVolts (10E-6)
 void CalibrateAVCC(void)
 {
@@ -52,7 +55,7 @@ void CalibrateAVCC(void)
     }
     else if ( (command_done == 11) )
     {  
-        printf_P(PSTR("\"extern_avcc\":\"%1.4f\","),(ref_extern_avcc_uV/1.0E6));
+        printf_P(PSTR("\"extern_avcc\":\"%s\","), fixed_to_str(fixed_buf, ref_extern_avcc_uV, 6, 4) );
         command_done = 12;
     }
     else if ( (command_done == 12) )
@@ -92,7 +95,7 @@ void Calibrate1V1(void)
     }
     else if ( (command_done == 11) )
     {
-        printf_P(PSTR("\"intern_1v1\":\"%1.4f\","),(ref_intern_1v1_uV/1.0E6));
+        printf_P(PSTR("\"intern_1v1\":\"%s\","), fixed_to_str(fixed_buf, ref_intern_1v1_uV, 6, 4) );
         command_done = 12;
     }
     else if ( (command_done == 12) )
@@ -130,12 +133,12 @@ void ReFmEe(void)
     }
     else if ( (command_done == 11) )
     {  
-        printf_P(PSTR("\"extern_avcc\":\"%1.4f\","),(ref_extern_avcc_uV/1.0E6));
+        printf_P(PSTR("\"extern_avcc\":\"%s\","), fixed_to_str(fixed_buf, ref_extern_avcc_uV, 6, 4) );
         command_done = 12;
     }
     else if ( (command_done == 12) )
     {
-        printf_P(PSTR("\"intern_1v1\":\"%1.4f\","),(ref_intern_1v1_uV/1.0E6));
+        printf_P(PSTR("\"intern_1v1\":\"%s\","), fixed_to_str(fixed_buf, ref_intern_1v1_uV, 6, 4) );
         command_done = 13;
     }
     else if ( (command_done == 13) )
@@ -174,7 +177,7 @@ void Ref2Ee(void)
     {
         if (WriteEeReferenceAvcc())
         {
-            printf_P(PSTR("\"extern_avcc\":\"%1.4f\","),(ref_extern_avcc_uV/1.0E6));
+            printf_P(PSTR("\"extern_avcc\":\"%s\","), fixed_to_str(fixed_buf, ref_extern_avcc_uV, 6, 4) );
             command_done = 12;
         }
     }
@@ -182,7 +185,7 @@ void Ref2Ee(void)
     {
         if (WriteEeReference1V1())
         {
-            printf_P(PSTR("\"intern_1v1\":\"%1.4f\","),(ref_intern_1v1_uV/1.0E6));
+            printf_P(PSTR("\"intern_1v1\":\"%s\","), fixed_to_str(fixed_buf, ref_intern_1v1_uV, 6, 4) );
             command_done = 13;
         }
     }
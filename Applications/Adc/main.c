@@ -29,8 +29,8 @@ https://en.wikipedia.org/wiki/BSD_licenses#0-clause_license_(%22Zero_Clause_BSD%
 #include "analog.h"
 #include "calibrate.h"
 
-#define ADC_DELAY_MILSEC 200UL
-static unsigned long adc_started_at;
+// a burst every 195 Timer0 overflows (199.7 mSec at 16MHz)
+#define ADC_TRIGGER_TICKS 195
 
 #define BLINK_DELAY 1000UL
 static unsigned long blink_started_at;
@@ -75,9 +75,8 @@ void setup(void)
     init_ADC_single_conversion(EXTERNAL_AVCC); // warning AREF must not be connected to anything
     uart0_init(0,0); // bootloader may have the UART enabled, a zero baudrate will disconnect it.
 
-    // put ADC in Auto Trigger mode and fetch an array of channels
-    enable_ADC_auto_conversion(BURST_MODE);
-    adc_started_at = milliseconds();
+    // put ADC in Auto Trigger mode with Timer0 as the trigger and fetch an array of channels
+    enable_ADC_timer_trigger(ADC_TRIGGER_TICKS);
 
     /* Initialize UART to 38.4kbps, it returns a pointer to FILE so redirect of stdin and stdout works*/
     stderr = stdout = stdin = uart0_init(38400UL, UART0_RX_REPLACE_CR_WITH_NL);
@@ -116,16 +115,6 @@ void blink(void)
     }
 }
 
-void adc_burst(void)
-{
-    unsigned long kRuntime= elapsed(&adc_started_at);
-    if ((kRuntime) > ((unsigned long)ADC_DELAY_MILSEC))
-    {
-        enable_ADC_auto_conversion(BURST_MODE);
-        adc_started_at += ADC_DELAY_MILSEC; 
-    } 
-}
-
 int main(void) 
 {
     setup();
@@ -134,6 +123,9 @@ int main(void)
     { 
         // use LED to show if I2C has a bus manager
         blink();
+
+        // let the next Timer0 overflow start an ADC burst when one is due
+        arm_ADC_timer_trigger();
         
         // check if character is available to assemble a command, e.g. non-blocking
         if ( (!command_done) && uart0_available() ) // command_done is an extern from parse.h
@@ -155,9 +147,6 @@ int main(void)
             initCommandBuffer();
         }
         
-        // delay between ADC burst
-        adc_burst();
-          
         // finish echo of the command line befor starting a reply (or the next part of a reply)
         if ( command_done && uart0_availableForWrite() )
         {
@@ -32,6 +32,11 @@ volatile DAYNIGHT_STATE_t daynight_state;
 
 static unsigned long daynight_serial_print_started_at;
 
+// one snapshot transaction has the manager values for a report
+static MGR_DAYNIGHT_SNAPSHOT_t dn_snapshot;
+static uint8_t dn_snapshot_ok;
+static TWI0_LOOP_STATE_t dn_loop_state = TWI0_LOOP_STATE_DONE;
+
 // /0//day?
 // report on daynight state machine, threshold and debounce settings, adc reading, and elapsed time since dayTmrStarted
 void dnReport(unsigned long serial_print_delay_milsec)
@@ -40,117 +45,91 @@ void dnReport(unsigned long serial_print_delay_milsec)
     {
         daynight_serial_print_started_at = milliseconds();
         printf_P(PSTR("{\"state\":\"0x%X\","),daynight_state); // print a hex value
-        command_done = 12;
+        dn_loop_state = TWI0_LOOP_STATE_INIT;
+        command_done = 11;
         return;
     }
-    else if ( (command_done == 12) ) 
-    {
-        int local_copy = 0;
-        TWI0_LOOP_STATE_t loop_state = TWI0_LOOP_STATE_INIT;
-        while (loop_state != TWI0_LOOP_STATE_DONE)
+    else if ( (command_done == 11) ) 
+    { // the manager values are read with one snapshot transaction
+        dn_snapshot_ok = i2c_daynight_snapshot(&dn_snapshot, &dn_loop_state);
+        if (dn_loop_state == TWI0_LOOP_STATE_DONE)
         {
-            local_copy = i2c_int_rwoff_access_cmd(DAYNIGHT_INT_CMD,DAYNIGHT_MORNING_THRESHOLD,0,&loop_state);
+            command_done = 12;
         }
+        return;
+    }
+    else if ( (command_done == 12) ) 
+    {
         printf_P(PSTR("\"mor_threshold\":"));
-        if (mgr_twiErrorCode)
+        if (!dn_snapshot_ok)
         {
             printf_P(PSTR("\"err%d\","),mgr_twiErrorCode);
         }
         else
         {
-            printf_P(PSTR("\"%u\","),local_copy);
+            printf_P(PSTR("\"%u\","),dn_snapshot.morning_threshold);
         }
         command_done = 13;
         return;
     }
     else if ( (command_done == 13) ) 
     {
-        int local_copy = 0;
-        TWI0_LOOP_STATE_t loop_state = TWI0_LOOP_STATE_INIT;
-        while (loop_state != TWI0_LOOP_STATE_DONE)
-        {
-            local_copy = i2c_int_rwoff_access_cmd(DAYNIGHT_INT_CMD,DAYNIGHT_EVENING_THRESHOLD,0,&loop_state);
-        }
         printf_P(PSTR("\"eve_threshold\":"));
-        if (mgr_twiErrorCode)
+        if (!dn_snapshot_ok)
         {
             printf_P(PSTR("\"err%d\","),mgr_twiErrorCode);
         }
         else
         {
-            printf_P(PSTR("\"%u\","),local_copy);
+            printf_P(PSTR("\"%u\","),dn_snapshot.evening_threshold);
         }
         command_done = 14;
         return;
     }
     else if ( (command_done == 14) ) 
     {
-        int adc_reads = 0;
-        TWI0_LOOP_STATE_t loop_state = TWI0_LOOP_STATE_INIT;
-        while (loop_state != TWI0_LOOP_STATE_DONE)
-        {
-            adc_reads = i2c_get_adc_from_manager(ADC_CH_MGR_ALT_V,&loop_state);
-        }
-        printf_P(PSTR("\"adc_alt_v\":\"%u\","),adc_reads);
+        printf_P(PSTR("\"adc_alt_v\":\"%u\","),dn_snapshot_ok ? dn_snapshot.adc_alt_v : 0);
         command_done = 15;
         return;
     }
     else if ( (command_done == 15) ) 
     {
-        unsigned long local_copy = 0;
-        TWI0_LOOP_STATE_t loop_state = TWI0_LOOP_STATE_INIT;
-        while (loop_state != TWI0_LOOP_STATE_DONE)
-        {
-            local_copy = i2c_ul_rwoff_access_cmd(DAYNIGHT_UL_CMD,DAYNIGHT_MORNING_DEBOUNCE,0,&loop_state);
-        }
         printf_P(PSTR("\"mor_debounce\":"));
-        if (mgr_twiErrorCode)
+        if (!dn_snapshot_ok)
         {
             printf_P(PSTR("\"err%d\","),mgr_twiErrorCode);
         }
         else
         {
-            printf_P(PSTR("\"%lu\","),local_copy);
+            printf_P(PSTR("\"%lu\","),dn_snapshot.morning_debounce);
         }
         command_done = 16;
         return;
     }
     else if ( (command_done == 16) ) 
     {
-        unsigned long local_copy = 0;
-        TWI0_LOOP_STATE_t loop_state = TWI0_LOOP_STATE_INIT;
-        while (loop_state != TWI0_LOOP_STATE_DONE)
-        {
-            local_copy = i2c_ul_rwoff_access_cmd(DAYNIGHT_UL_CMD,DAYNIGHT_EVENING_DEBOUNCE,0,&loop_state);
-        }
         printf_P(PSTR("\"eve_debounce\":"));
-        if (mgr_twiErrorCode)
+        if (!dn_snapshot_ok)
         {
             printf_P(PSTR("\"err%d\","),mgr_twiErrorCode);
         }
         else
         {
-            printf_P(PSTR("\"%lu\","),local_copy);
+            printf_P(PSTR("\"%lu\","),dn_snapshot.evening_debounce);
         }
         command_done = 17;
         return;
     }
     else if ( (command_done == 17) ) 
     {
-        unsigned long local_copy = 0;
-        TWI0_LOOP_STATE_t loop_state = TWI0_LOOP_STATE_INIT;
-        while (loop_state != TWI0_LOOP_STATE_DONE)
-        {
-            local_copy = i2c_ul_rwoff_access_cmd(DAYNIGHT_UL_CMD,DAYNIGHT_ELAPSED_TIMER,0,&loop_state);
-        }
         printf_P(PSTR("\"dn_timer\":"));
-        if (mgr_twiErrorCode)
+        if (!dn_snapshot_ok)
         {
             printf_P(PSTR("\"err%d\","),mgr_twiErrorCode);
         }
         else
         {
-            printf_P(PSTR("\"%lu\""),local_copy);
+            printf_P(PSTR("\"%lu\""),dn_snapshot.timer);
         }
         command_done = 24;
         return;
@@ -23,6 +23,7 @@ https://en.wikipedia.org/wiki/BSD_licenses#0-clause_license_(%22Zero_Clause_BSD%
 #include <util/delay.h>
 #include "../lib/uart0_bsd.h"
 #include "../lib/parse.h"
+#include "../lib/dispatch.h"
 #include "../lib/timers_bsd.h"
 #include "../lib/adc_bsd.h"
 #include "../lib/twi0_bsd.h"
@@ -45,34 +46,28 @@ char rpu_addr;
 uint8_t rpu_addr_is_fake;
 uint8_t manager_status;
 
-void ProcessCmd()
-{ 
-    if ( (strcmp_P( command, PSTR("/id?")) == 0) && ( (arg_count == 0) || (arg_count == 1)) )
-    {
-        Id("DayNight"); // ../Uart/id.c
-    }
-    if ( (strcmp_P( command, PSTR("/day?")) == 0) && ( (arg_count == 0 ) ) )
-    {
-        dnReport(5000UL); // report daynight state machine every 5 sec until terminated
-    }
-    if ( (strcmp_P( command, PSTR("/dnmthresh?")) == 0) && ( (arg_count == 0) || (arg_count == 1)) )
-    {
-        dnMorningThreshold(); // set daynight state machine daynight_morning_threshold
-    }
-    if ( (strcmp_P( command, PSTR("/dnethresh?")) == 0) && ( (arg_count == 0) || (arg_count == 1)) )
-    {
-        dnEveningThreshold(); // set daynight state machine daynight_evening_threshold
-    }
-    if ( (strcmp_P( command, PSTR("/dnmdebounc?")) == 0) && ( (arg_count == 0) || (arg_count == 1)) )
-    {
-        dnMorningDebounce(); // set daynight state machine daynight_morning_debounce
-    }
-    if ( (strcmp_P( command, PSTR("/dnedebounc?")) == 0) && ( (arg_count == 0) || (arg_count == 1)) )
-    {
-        dnEveningDebounce(); // set daynight state machine daynight_evening_debounce
-    }
+// commands with an argument for the handler
+static void IdCmd(void)
+{
+    Id("DayNight"); // ../Uart/id.c
 }
 
+static void dnReportCmd(void)
+{
+    dnReport(5000UL); // report daynight state machine every 5 sec until terminated
+}
+
+// command table is looked up once by resolveCommand() from ../lib/dispatch.c
+static const DISPATCH_t cmd_table[] PROGMEM = 
+{
+    DISPATCH_CMD("/id?", 0, 1, IdCmd),
+    DISPATCH_CMD("/day?", 0, 0, dnReportCmd),
+    DISPATCH_CMD("/dnmthresh?", 0, 1, dnMorningThreshold), // set daynight state machine daynight_morning_threshold
+    DISPATCH_CMD("/dnethresh?", 0, 1, dnEveningThreshold), // set daynight state machine daynight_evening_threshold
+    DISPATCH_CMD("/dnmdebounc?", 0, 1, dnMorningDebounce), // set daynight state machine daynight_morning_debounce
+    DISPATCH_CMD("/dnedebounc?", 0, 1, dnEveningDebounce) // set daynight state machine daynight_evening_debounce
+};
+
 // these functions can be registered as callbacks 
 // so the manager can update the application over i2c
 void daynight_state_event(uint8_t daynight_state_from_mgr)
@@ -224,12 +219,16 @@ void setup(void)
     // register applicaiton's i2c callbacks
     // then register the callback address and routes with the manager so it can keep the app up to date 
     register_application_callbacks();
+    mgr_twiErrorCode = 0;
     i2c_daynight_cmd(I2C0_APP_ADDR,CB_ROUTE_DN_STATE,CB_ROUTE_DN_DAYWK,CB_ROUTE_DN_NIGHTWK);
     if (mgr_twiErrorCode)
     {
         printf_P(PSTR("\"%c\"daynight_error %d\r\n"),rpu_addr,mgr_twiErrorCode);
         abort_safe();
     }
+
+    // registering turns batches off (an older application does not know them), so set the batch route last
+    i2c_event_batch_cmd(CB_ROUTE_EVENTS); // events that wait in the manager are sent together (an older manager sends each)
 }
 
 void blink_mgr_status(void)
@@ -367,13 +366,14 @@ int main(void)
                     findCommand(); // ../lib/parse.c
                     // steps 2..9 are skipped. Reserved for more complex parse
                     command_done = 10;
+                    resolveCommand(cmd_table, DISPATCH_SIZE(cmd_table));
                 }
 
                 // do not overfill the serial buffer since that blocks looping, e.g. process a command in 32 byte chunks
                 if ( (command_done >= 10) && (command_done < 250) )
                 {
                     // setps 10..249 are moved through by the procedure selected
-                     ProcessCmd();
+                     runCommand();
                 }
                 else 
                 {
@@ -23,6 +23,7 @@ https://en.wikipedia.org/wiki/BSD_licenses#0-clause_license_(%22Zero_Clause_BSD%
 #include <util/delay.h>
 #include "../lib/uart0_bsd.h"
 #include "../lib/parse.h"
+#include "../lib/dispatch.h"
 #include "../lib/timers_bsd.h"
 #include "../lib/adc_bsd.h"
 #include "../lib/twi0_bsd.h"
@@ -48,78 +49,54 @@ static char rpu_addr;
 static uint8_t rpu_addr_is_fake;
 uint8_t manager_status;
 
-void ProcessCmd()
-{ 
-    if ( (strcmp_P( command, PSTR("/id?")) == 0) && ( (arg_count == 0) || (arg_count == 1)) )
-    {
-        Id("Shutdown"); 
-    }
-    if ( (strcmp_P( command, PSTR("/analog?")) == 0) && ( (arg_count >= 1 ) && (arg_count <= 5) ) )
-    {
-        Analog(5000UL); 
-    }
-    if ( (strcmp_P( command, PSTR("/day?")) == 0) && ( (arg_count == 0 ) ) )
-    {
-        dnReport(5000UL); 
-    }
-    if ( (strcmp_P( command, PSTR("/dnmthresh?")) == 0) && ( (arg_count == 0) || (arg_count == 1)) )
-    {
-        dnMorningThreshold(); // set daynight state machine daynight_morning_threshold
-    }
-    if ( (strcmp_P( command, PSTR("/dnethresh?")) == 0) && ( (arg_count == 0) || (arg_count == 1)) )
-    {
-        dnEveningThreshold(); // set daynight state machine daynight_evening_threshold
-    }
-    if ( (strcmp_P( command, PSTR("/dnmdebounc?")) == 0) && ( (arg_count == 0) || (arg_count == 1)) )
-    {
-        dnMorningDebounce(); // set daynight state machine daynight_morning_debounce
-    }
-    if ( (strcmp_P( command, PSTR("/dnedebounc?")) == 0) && ( (arg_count == 0) || (arg_count == 1)) )
-    {
-        dnEveningDebounce(); // set daynight state machine daynight_evening_debounce
-    }
-    if ( (strcmp_P( command, PSTR("/bm")) == 0) && ( (arg_count == 0 ) ) )
-    {
-        EnableBatMngCntl(); 
-    }
-    if ( (strcmp_P( command, PSTR("/bmcntl?")) == 0) && ( (arg_count == 0 ) ) )
-    {
-        ReportBatMngCntl(5000UL);  
-    }
-    if ( (strcmp_P( command, PSTR("/bmlow?")) == 0) && ( (arg_count == 0) || (arg_count == 1)) )
-    {
-        BatMngLowLimit();  // set battery manager battery_low_limit
-    }
-    if ( (strcmp_P( command, PSTR("/bmhigh?")) == 0) && ( (arg_count == 0) || (arg_count == 1)) )
-    {
-        BatMngHighLimit(); // set battery manager battery_high_limit
-    }
-    if ( (strcmp_P( command, PSTR("/hs")) == 0) && ( (arg_count == 0 ) ) )
-    {
-        EnableShutdownCntl(); 
-    }
-    if ( (strcmp_P( command, PSTR("/hscntl?")) == 0) && ( (arg_count == 0 ) ) )
-    {
-        ReportShutdownCntl(5000UL);  
-    }
-    if ( (strcmp_P( command, PSTR("/hshaltcurr?")) == 0) && ( (arg_count == 0) || (arg_count == 1)) )
-    {
-        ShutdownHaltCurrLimit();
-    }
-    if ( (strcmp_P( command, PSTR("/hsttl?")) == 0) && ( (arg_count == 0) || (arg_count == 1)) )
-    {
-        ShutdownTTLimit();
-    }
-    if ( (strcmp_P( command, PSTR("/hsdelay?")) == 0) && ( (arg_count == 0) || (arg_count == 1)) )
-    {
-        ShutdownDelayLimit();
-    }
-    if ( (strcmp_P( command, PSTR("/hswearlv?")) == 0) && ( (arg_count == 0) || (arg_count == 1)) )
-    {
-        ShutdownWearlevelingLimit();
-    }
+// commands with an argument for the handler
+static void IdCmd(void)
+{
+    Id("Shutdown");
+}
+
+static void AnalogCmd(void)
+{
+    Analog(5000UL);
 }
 
+static void dnReportCmd(void)
+{
+    dnReport(5000UL);
+}
+
+static void ReportBatMngCntlCmd(void)
+{
+    ReportBatMngCntl(5000UL);
+}
+
+static void ReportShutdownCntlCmd(void)
+{
+    ReportShutdownCntl(5000UL);
+}
+
+// command table is looked up once by resolveCommand() from ../lib/dispatch.c
+static const DISPATCH_t cmd_table[] PROGMEM = 
+{
+    DISPATCH_CMD("/id?", 0, 1, IdCmd),
+    DISPATCH_CMD("/analog?", 1, 5, AnalogCmd),
+    DISPATCH_CMD("/day?", 0, 0, dnReportCmd),
+    DISPATCH_CMD("/dnmthresh?", 0, 1, dnMorningThreshold), // set daynight state machine daynight_morning_threshold
+    DISPATCH_CMD("/dnethresh?", 0, 1, dnEveningThreshold), // set daynight state machine daynight_evening_threshold
+    DISPATCH_CMD("/dnmdebounc?", 0, 1, dnMorningDebounce), // set daynight state machine daynight_morning_debounce
+    DISPATCH_CMD("/dnedebounc?", 0, 1, dnEveningDebounce), // set daynight state machine daynight_evening_debounce
+    DISPATCH_CMD("/bm", 0, 0, EnableBatMngCntl),
+    DISPATCH_CMD("/bmcntl?", 0, 0, ReportBatMngCntlCmd),
+    DISPATCH_CMD("/bmlow?", 0, 1, BatMngLowLimit), // set battery manager battery_low_limit
+    DISPATCH_CMD("/bmhigh?", 0, 1, BatMngHighLimit), // set battery manager battery_high_limit
+    DISPATCH_CMD("/hs", 0, 0, EnableShutdownCntl),
+    DISPATCH_CMD("/hscntl?", 0, 0, ReportShutdownCntlCmd),
+    DISPATCH_CMD("/hshaltcurr?", 0, 1, ShutdownHaltCurrLimit),
+    DISPATCH_CMD("/hsttl?", 0, 1, ShutdownTTLimit),
+    DISPATCH_CMD("/hsdelay?", 0, 1, ShutdownDelayLimit),
+    DISPATCH_CMD("/hswearlv?", 0, 1, ShutdownWearlevelingLimit)
+};
+
 // these functions can be registered as callbacks 
 // so the manager can update the application over i2c
 void daynight_state_event(uint8_t daynight_state_from_mgr)
@@ -260,6 +237,7 @@ void setup(void)
     // register applicaiton's i2c callbacks
     // then register the callback address and routes with the manager so it can keep the app up to date 
     register_application_callbacks();
+    mgr_twiErrorCode = 0;
     i2c_daynight_cmd(I2C0_APP_ADDR,CB_ROUTE_DN_STATE,CB_ROUTE_DN_DAYWK,CB_ROUTE_DN_NIGHTWK);
     if (mgr_twiErrorCode)
     {
@@ -281,6 +259,9 @@ void setup(void)
         abort_safe();
     }
 
+    // i2c_daynight_cmd (cmd 19) turns batches off (an older application does not know them), so set the batch route last
+    i2c_event_batch_cmd(CB_ROUTE_EVENTS); // events that wait in the manager are sent together (an older manager sends each)
+
     // the host is likely DOWN at power up, and hs_state is not yet getting callbacks so I guess init it for now
     hs_state = HOSTSHUTDOWN_STATE_DOWN;
 }
@@ -447,12 +428,13 @@ int main(void)
                 {
                     findCommand();
                     command_done = 10;
+                    resolveCommand(cmd_table, DISPATCH_SIZE(cmd_table));
                 }
                 
                 // do not overfill the serial buffer since that blocks looping, e.g. process a command in 32 byte chunks
                 if ( (command_done >= 10) && (command_done < 250) )
                 {
-                     ProcessCmd();
+                     runCommand();
                 }
                 else 
                 {
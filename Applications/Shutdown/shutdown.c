@@ -29,6 +29,12 @@ https://en.wikipedia.org/wiki/BSD_licenses#0-clause_license_(%22Zero_Clause_BSD%
 #include "shutdown.h"
 
 static unsigned long hs_serial_print_started_at;
+
+// one snapshot transaction has the manager values for a report
+static MGR_SHUTDOWN_SNAPSHOT_t hs_snapshot;
+static uint8_t hs_snapshot_ok;
+static TWI0_LOOP_STATE_t hs_loop_state = TWI0_LOOP_STATE_DONE;
+
 volatile HOSTSHUTDOWN_STATE_t hs_state;
 uint8_t hs_bring_up;
 
@@ -96,126 +102,99 @@ void ReportShutdownCntl(unsigned long serial_print_delay_milsec)
     if ( (command_done == 11) )
     {
         printf_P(PSTR("{\"hs_state\":\"0x%X\","),hs_state); // print a hex value
+        hs_loop_state = TWI0_LOOP_STATE_INIT;
         command_done = 12;
         return;
     }
     else if ( (command_done == 12) ) 
-    {
-        int local_copy = 0;
-        TWI0_LOOP_STATE_t loop_state = TWI0_LOOP_STATE_INIT;
-        while (loop_state != TWI0_LOOP_STATE_DONE)
-        {
-            local_copy = i2c_int_rwoff_access_cmd(SHUTDOWN_INT_CMD,SHUTDOWN_HALT_CURR_OFFSET,0,&loop_state);
-        }
-        printf_P(PSTR("\"hs_halt_curr\":"));
-        if (mgr_twiErrorCode)
-        {
-            printf_P(PSTR("\"err%d\","),mgr_twiErrorCode);
-        }
-        else
+    { // the manager values are read with one snapshot transaction
+        hs_snapshot_ok = i2c_shutdown_snapshot(&hs_snapshot, &hs_loop_state);
+        if (hs_loop_state == TWI0_LOOP_STATE_DONE)
         {
-            printf_P(PSTR("\"%u\","),local_copy);
+            command_done = 13;
         }
-        command_done = 13;
         return;
     }
     else if ( (command_done == 13) ) 
     {
-        int adc_reads = 0;
-        TWI0_LOOP_STATE_t loop_state = TWI0_LOOP_STATE_INIT;
-        while (loop_state != TWI0_LOOP_STATE_DONE)
-        {
-            adc_reads = i2c_get_adc_from_manager(ADC_CH_MGR_PWR_I,&loop_state);
-        }
-        printf_P(PSTR("\"adc_pwr_i\":"));
-        if (mgr_twiErrorCode)
+        printf_P(PSTR("\"hs_halt_curr\":"));
+        if (!hs_snapshot_ok)
         {
             printf_P(PSTR("\"err%d\","),mgr_twiErrorCode);
         }
         else
         {
-            printf_P(PSTR("\"%u\","),adc_reads);
+            printf_P(PSTR("\"%u\","),hs_snapshot.halt_curr);
         }
         command_done = 14;
         return;
     }
     else if ( (command_done == 14) ) 
     {
-        unsigned long local_copy = 0;
-        TWI0_LOOP_STATE_t loop_state = TWI0_LOOP_STATE_INIT;
-        while (loop_state != TWI0_LOOP_STATE_DONE)
-        {
-            local_copy = i2c_ul_rwoff_access_cmd(SHUTDOWN_UL_CMD,SHUTDOWN_TTL,0,&loop_state);
-        }
-        printf_P(PSTR("\"hs_ttl\":"));
-        if (mgr_twiErrorCode)
+        printf_P(PSTR("\"adc_pwr_i\":"));
+        if (!hs_snapshot_ok)
         {
             printf_P(PSTR("\"err%d\","),mgr_twiErrorCode);
         }
         else
         {
-            printf_P(PSTR("\"%lu\","),local_copy);
+            printf_P(PSTR("\"%u\","),hs_snapshot.adc_pwr_i);
         }
         command_done = 15;
         return;
     }
     else if ( (command_done == 15) ) 
     {
-        unsigned long local_copy = 0;
-        TWI0_LOOP_STATE_t loop_state = TWI0_LOOP_STATE_INIT;
-        while (loop_state != TWI0_LOOP_STATE_DONE)
-        {
-            local_copy = i2c_ul_rwoff_access_cmd(SHUTDOWN_UL_CMD,SHUTDOWN_DELAY,0,&loop_state);
-        }
-        printf_P(PSTR("\"hs_delay\":"));
-        if (mgr_twiErrorCode)
+        printf_P(PSTR("\"hs_ttl\":"));
+        if (!hs_snapshot_ok)
         {
             printf_P(PSTR("\"err%d\","),mgr_twiErrorCode);
         }
         else
         {
-            printf_P(PSTR("\"%lu\","),local_copy);
+            printf_P(PSTR("\"%lu\","),hs_snapshot.ttl);
         }
         command_done = 16;
         return;
     }
-
     else if ( (command_done == 16) ) 
     {
-        unsigned long local_copy = 0;
-        TWI0_LOOP_STATE_t loop_state = TWI0_LOOP_STATE_INIT;
-        while (loop_state != TWI0_LOOP_STATE_DONE)
-        {
-            local_copy = i2c_ul_rwoff_access_cmd(SHUTDOWN_UL_CMD,SHUTDOWN_WEARLEVEL,0,&loop_state);
-        }
-        printf_P(PSTR("\"hs_wearlv\":"));
-        if (mgr_twiErrorCode)
+        printf_P(PSTR("\"hs_delay\":"));
+        if (!hs_snapshot_ok)
         {
             printf_P(PSTR("\"err%d\","),mgr_twiErrorCode);
         }
         else
         {
-            printf_P(PSTR("\"%lu\","),local_copy);
+            printf_P(PSTR("\"%lu\","),hs_snapshot.delay);
         }
         command_done = 17;
         return;
     }
     else if ( (command_done == 17) ) 
     {
-        unsigned long local_copy = 0;
-        TWI0_LOOP_STATE_t loop_state = TWI0_LOOP_STATE_INIT;
-        while (loop_state != TWI0_LOOP_STATE_DONE)
+        printf_P(PSTR("\"hs_wearlv\":"));
+        if (!hs_snapshot_ok)
         {
-            local_copy = i2c_ul_rwoff_access_cmd(SHUTDOWN_UL_CMD,SHUTDOWN_KRUNTIME,0,&loop_state);
+            printf_P(PSTR("\"err%d\","),mgr_twiErrorCode);
         }
+        else
+        {
+            printf_P(PSTR("\"%lu\","),hs_snapshot.wearlevel);
+        }
+        command_done = 18;
+        return;
+    }
+    else if ( (command_done == 18) ) 
+    {
         printf_P(PSTR("\"hs_timer\":")); // elapsed timer used by state machine
-        if (mgr_twiErrorCode)
+        if (!hs_snapshot_ok)
         {
             printf_P(PSTR("\"err%d\""),mgr_twiErrorCode);
         }
         else
         {
-            printf_P(PSTR("\"%lu\""),local_copy);
+            printf_P(PSTR("\"%lu\""),hs_snapshot.timer);
         }
         command_done = 24;
         return;
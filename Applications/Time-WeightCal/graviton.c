@@ -0,0 +1,331 @@
+/*
+Graviton is the integer part of the Time-Weight gravimetric calibration (START/STOP run with flow pulses)
+Copyright (C) 2020 Ronald Sutherland
+
+Permission to use, copy, modify, and/or distribute this software for any purpose with or without fee is hereby granted.
+
+THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE
+FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY
+DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS,
+WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION,
+ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+https://en.wikipedia.org/wiki/BSD_licenses#0-clause_license_(%22Zero_Clause_BSD%22)
+*/
+
+#include <stdbool.h>
+#include <avr/pgmspace.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "../lib/parse.h"
+#include "../lib/icp_bsd.h"
+#include "../lib/frame_bsd.h"
+#include "graviton.h"
+
+// ICP1 events are drained in batches, a run only needs the snapshots taken by the ICP3/ICP4 ISRs
+#define FLOW_BATCH 8
+static uint64_t flow_batch[FLOW_BATCH];
+
+static uint32_t start_count_at_arm;
+static uint32_t stop_count_at_arm;
+
+static ICP_SNAPSHOT_t start_snap;
+static ICP_SNAPSHOT_t stop_snap;
+static uint32_t start_age[ICP1_SNAPSHOT_SIZE];
+static uint32_t stop_age[ICP1_SNAPSHOT_SIZE];
+static uint8_t age_index;
+
+// a FLOW frame has the ICP1 lost count and then as many 46 bit events as fit
+#define FLOW_EVENTS_PER_FRAME ((FRAME_PAYLOAD_MAX - 2) / 6)
+static bool flow_streaming;
+static uint8_t payload[FRAME_PAYLOAD_MAX];
+
+// crystal counts from a recent ICP1 event to the START or STOP event (a full day does not fit, so limit it)
+static uint32_t age_of(uint64_t event, uint64_t icp1_event)
+{
+    uint64_t age = (event - icp1_event) & ICP_EVENT_MASK;
+    if (age > 0xFFFFFFFFULL) return 0xFFFFFFFFUL;
+    return (uint32_t) age;
+}
+
+// avr-libc printf does not do 64 bit integers, a 46 bit event time is printed in two parts.
+void PrintEventTime(uint64_t event)
+{
+    if (event >= 1000000000ULL)
+    {
+        printf_P(PSTR("%lu%09lu"), (unsigned long) (event / 1000000000ULL), (unsigned long) (event % 1000000000ULL));
+    }
+    else
+    {
+        printf_P(PSTR("%lu"), (unsigned long) event);
+    }
+}
+
+// keep the ICP1 buffer from filling, the run only needs the count and snapshots
+void DrainFlowEvents(void)
+{
+    if (flow_streaming)
+    {
+        if (command_done >= 10) return; // Flow() is sending the events
+        flow_streaming = false; // the flow command was ended
+    }
+    while (icp1_read(flow_batch, FLOW_BATCH) == FLOW_BATCH);
+}
+
+// binary run record: RUN frame, RUN_AGES frames with up to four ages each, and a RUN_END frame.
+// A frame that does not fit in the UART0 transmit buffer is sent again on a later loop, age_index only moves when it was sent.
+static void send_run_ages(uint8_t which, uint32_t *ages, uint8_t count)
+{
+    uint8_t used = 0;
+    payload[used++] = which;
+    payload[used++] = age_index;
+    uint8_t next = age_index;
+    while ( (next < count) && ((next - age_index) < 4) )
+    {
+        used += frame_pack_u32(&payload[used], ages[next++]);
+    }
+    if (frame_send(FRAME_TYPE_RUN_AGES, payload, used))
+    {
+        age_index = next;
+    }
+}
+
+/* arm for a START (ICP3) then STOP (ICP4) run and report the integers when it is done
+   Partial = (Stop - Start) - (StopFTbuffer[0] - StartFTbuffer[0]), which is the same as stop_age[0] - start_age[0] */
+void Run(void)
+{
+    if ( (command_done == 10) )
+    {
+        icp1_reset_buffer();
+        start_count_at_arm = icpCountAtomic(ICP_CH_ICP3);
+        stop_count_at_arm = icpCountAtomic(ICP_CH_ICP4);
+        command_done = 11;
+    }
+    else if ( (command_done == 11) )
+    { // wait for START
+        if (icpCountAtomic(ICP_CH_ICP3) != start_count_at_arm)
+        {
+            icpSnapshotAtomic(ICP_SNAP_START, &start_snap);
+            command_done = 12; // a STOP may already be captured, so stop_count_at_arm is kept
+        }
+    }
+    else if ( (command_done == 12) )
+    { // wait for STOP
+        uint32_t stop_count = icpCountAtomic(ICP_CH_ICP4);
+        if (stop_count != stop_count_at_arm)
+        {
+            icpSnapshotAtomic(ICP_SNAP_STOP, &stop_snap);
+            if ( ((stop_snap.event - start_snap.event) & ICP_EVENT_MASK) > (ICP_EVENT_MASK >> 1) )
+            { 
+                // the STOP was befor the START, wait for the next one (a STOP after the count was read is seen on a later loop)
+                stop_count_at_arm = stop_count;
+                return;
+            }
+            if (icpCountAtomic(ICP_CH_ICP3) != (start_count_at_arm + 1))
+            {
+                printf_P(PSTR("{\"err\":\"RunStartTwice\"}\r\n"));
+                initCommandBuffer();
+                return;
+            }
+            if ( (start_snap.icp1_recent_count == 0) || (stop_snap.icp1_recent_count == 0) )
+            {
+                printf_P(PSTR("{\"err\":\"RunNoFlow\"}\r\n"));
+                initCommandBuffer();
+                return;
+            }
+            for (uint8_t i = 0; i < ICP1_SNAPSHOT_SIZE; i++)
+            {
+                start_age[i] = (i < start_snap.icp1_recent_count) ? age_of(start_snap.event, start_snap.icp1_recent[i]) : 0;
+                stop_age[i] = (i < stop_snap.icp1_recent_count) ? age_of(stop_snap.event, stop_snap.icp1_recent[i]) : 0;
+            }
+
+            if (frame_mode == FRAME_MODE_BINARY)
+            {
+                command_done = 29;
+                return;
+            }
+
+            // print in steps otherwise the serial buffer will fill and block the program from running
+            printf_P(PSTR("{\"run\":{\"start\":"));
+            PrintEventTime(start_snap.event);
+            command_done = 13;
+        }
+    }
+    else if ( (command_done == 13) )
+    {
+        printf_P(PSTR(",\"dur\":"));
+        PrintEventTime((stop_snap.event - start_snap.event) & ICP_EVENT_MASK);
+        command_done = 14;
+    }
+    else if ( (command_done == 14) )
+    {
+        printf_P(PSTR(",\"ft\":%lu"), (unsigned long) (stop_snap.icp1_count - start_snap.icp1_count));
+        command_done = 15;
+    }
+    else if ( (command_done == 15) )
+    {
+        printf_P(PSTR(",\"partial\":%ld"), (long) (stop_age[0] - start_age[0]));
+        printf_P(PSTR(",\"start_age\":["));
+        age_index = 0;
+        command_done = 16;
+    }
+    else if ( (command_done == 16) )
+    {
+        printf_P(PSTR("%lu"), start_age[age_index]);
+        if (++age_index < start_snap.icp1_recent_count)
+        {
+            printf_P(PSTR(","));
+        }
+        else
+        {
+            printf_P(PSTR("],\"stop_age\":["));
+            age_index = 0;
+            command_done = 17;
+        }
+    }
+    else if ( (command_done == 17) )
+    {
+        printf_P(PSTR("%lu"), stop_age[age_index]);
+        if (++age_index < stop_snap.icp1_recent_count)
+        {
+            printf_P(PSTR(","));
+        }
+        else
+        {
+            printf_P(PSTR("]"));
+            command_done = 18;
+        }
+    }
+    else if ( (command_done == 18) )
+    {
+        printf_P(PSTR(",\"div_lat\":[%u,%u]"), start_snap.diversion_latency, stop_snap.diversion_latency);
+        command_done = 19;
+    }
+    else if ( (command_done == 19) )
+    {
+        printf_P(PSTR(",\"lost\":%u,\"hw\":%u}}\r\n"), icp1_overflowAtomic(), icp1_high_water());
+        initCommandBuffer();
+    }
+    else if ( (command_done == 29) )
+    {
+        uint8_t used = frame_pack_u48(payload, start_snap.event);
+        used += frame_pack_u48(&payload[used], (stop_snap.event - start_snap.event) & ICP_EVENT_MASK);
+        used += frame_pack_u32(&payload[used], stop_snap.icp1_count - start_snap.icp1_count);
+        used += frame_pack_u32(&payload[used], stop_age[0] - start_age[0]);
+        used += frame_pack_u16(&payload[used], start_snap.diversion_latency);
+        used += frame_pack_u16(&payload[used], stop_snap.diversion_latency);
+        if (frame_send(FRAME_TYPE_RUN, payload, used))
+        {
+            age_index = 0;
+            command_done = 30;
+        }
+    }
+    else if ( (command_done == 30) )
+    {
+        send_run_ages(ICP_SNAP_START, start_age, start_snap.icp1_recent_count);
+        if (age_index >= start_snap.icp1_recent_count)
+        {
+            age_index = 0;
+            command_done = 31;
+        }
+    }
+    else if ( (command_done == 31) )
+    {
+        send_run_ages(ICP_SNAP_STOP, stop_age, stop_snap.icp1_recent_count);
+        if (age_index >= stop_snap.icp1_recent_count)
+        {
+            command_done = 32;
+        }
+    }
+    else if ( (command_done == 32) )
+    {
+        uint8_t used = frame_pack_u16(payload, icp1_overflowAtomic());
+        payload[used++] = icp1_high_water();
+        if (frame_send(FRAME_TYPE_RUN_END, payload, used))
+        {
+            initCommandBuffer();
+        }
+    }
+    else
+    {
+        initCommandBuffer();
+    }
+}
+
+/* stream ICP1 events in binary frames until a new command line is started */
+void Flow(void)
+{
+    if ( (command_done == 10) )
+    {
+        if (frame_mode != FRAME_MODE_BINARY)
+        {
+            printf_P(PSTR("{\"err\":\"FlowNeedsBinary\"}\r\n"));
+            initCommandBuffer();
+            return;
+        }
+        icp1_reset_buffer();
+        flow_streaming = true;
+        command_done = 11;
+    }
+    else if ( (command_done == 11) )
+    {
+        // events are only taken from the ICP1 buffer when a full FLOW frame fits in the UART0 transmit buffer
+        if (icp1_available() && (uart0_writeSpace() >= (FRAME_PAYLOAD_MAX + FRAME_OVERHEAD)))
+        {
+            uint8_t used = frame_pack_u16(payload, icp1_overflowAtomic());
+            uint8_t count = icp1_read(flow_batch, FLOW_EVENTS_PER_FRAME);
+            for (uint8_t i = 0; i < count; i++)
+            {
+                used += frame_pack_u48(&payload[used], flow_batch[i]);
+            }
+            frame_send(FRAME_TYPE_FLOW, payload, used);
+        }
+    }
+    else
+    {
+        initCommandBuffer();
+    }
+}
+
+// a /run? waiting for START or STOP, or a /flow? waiting for ICP1 events, has nothing to do until a capture ISR runs.
+// It is called with interrupts off when the main loop is about to sleep (see ../lib/idle_bsd.h).
+uint8_t GravitonWaiting(void)
+{
+    if (command == NULL) return 0;
+    if ( ((command_done == 11) || (command_done == 12)) && (strcmp_P( command, PSTR("/run?")) == 0) ) return 1;
+    return (command_done == 11) && (strcmp_P( command, PSTR("/flow?")) == 0);
+}
+
+/* select JSON text or binary frames for replies, /frame? [text|binary] */
+void FrameMode(void)
+{
+    if ( (command_done == 10) )
+    {
+        if (arg_count == 1)
+        {
+            if (strcmp_P( arg[0], PSTR("binary")) == 0)
+            {
+                frame_mode = FRAME_MODE_BINARY;
+            }
+            else if (strcmp_P( arg[0], PSTR("text")) == 0)
+            {
+                frame_mode = FRAME_MODE_TEXT;
+            }
+            else
+            {
+                printf_P(PSTR("{\"err\":\"FrameNotTextOrBinary\"}\r\n"));
+                initCommandBuffer();
+                return;
+            }
+        }
+        // the mode change reply is always text
+        printf_P(PSTR("{\"frame\":\"%S\",\"seq\":%u}\r\n"), (frame_mode == FRAME_MODE_BINARY) ? PSTR("binary") : PSTR("text"), frame_sequence);
+        initCommandBuffer();
+    }
+    else
+    {
+        initCommandBuffer();
+    }
+}
@@ -0,0 +1,17 @@
+#ifndef Graviton_H
+#define Graviton_H
+
+// binary frame types (see ../lib/frame_bsd.h)
+#define FRAME_TYPE_RUN 0x10
+#define FRAME_TYPE_RUN_AGES 0x11
+#define FRAME_TYPE_RUN_END 0x12
+#define FRAME_TYPE_FLOW 0x20
+
+extern void Run(void);
+extern void Flow(void);
+extern void FrameMode(void);
+extern void DrainFlowEvents(void);
+extern void PrintEventTime(uint64_t event);
+extern uint8_t GravitonWaiting(void);
+
+#endif // Graviton_H
@@ -0,0 +1,78 @@
+/*
+IsrLoop shows how often each ISR woke the MCU from idle sleep, its wake latency, and its ISR to loop time
+Copyright (C) 2020 Ronald Sutherland
+
+Permission to use, copy, modify, and/or distribute this software for any purpose with or without fee is hereby granted.
+
+THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE
+FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY
+DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS,
+WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION,
+ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+https://en.wikipedia.org/wiki/BSD_licenses#0-clause_license_(%22Zero_Clause_BSD%22)
+*/
+
+#include <stdbool.h>
+#include <avr/pgmspace.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "../lib/parse.h"
+#include "../lib/idle_bsd.h"
+#include "isrloop.h"
+
+static const char wake_name_0[] PROGMEM = "timer0";
+static const char wake_name_1[] PROGMEM = "uart0";
+static const char wake_name_2[] PROGMEM = "uart1";
+static const char wake_name_3[] PROGMEM = "uart2";
+static const char wake_name_4[] PROGMEM = "twi0";
+static const char wake_name_5[] PROGMEM = "twi1";
+static const char wake_name_6[] PROGMEM = "adc";
+static const char wake_name_7[] PROGMEM = "icp";
+static const char wake_name_8[] PROGMEM = "other";
+static PGM_P const wake_name[WAKE_SOURCES] PROGMEM = {
+    wake_name_0, wake_name_1, wake_name_2, wake_name_3, wake_name_4, wake_name_5, wake_name_6, wake_name_7, wake_name_8
+};
+
+static uint8_t wake_index;
+
+/* show [count, last, max, latency last, latency max] for each wake source, last and max are uSec from the ISR start to the main loop 
+   running again (held at 255 Timer0 counts). The wake latency is crystal counts from the interrupt to the ISR, measured from 
+   the capture time for icp and the datasheet bound (WAKE_LATENCY_BOUND) for the others. /isrloop? reset clears them after they are shown */
+void IsrLoop(void)
+{
+    if ( (command_done == 10) )
+    {
+        if ( (arg_count == 1) && (strcmp_P( arg[0], PSTR("reset")) != 0) )
+        {
+            printf_P(PSTR("{\"err\":\"IsrLoopNotReset\"}\r\n"));
+            initCommandBuffer();
+            return;
+        }
+        printf_P(PSTR("{\"isrloop\":{"));
+        wake_index = 0;
+        command_done = 11;
+    }
+    else if ( (command_done == 11) )
+    { // print in steps otherwise the serial buffer will fill and block the program from running
+        IDLE_WAKE_t wake;
+        idle_wake( (WAKE_t) wake_index, &wake);
+        printf_P(PSTR("\"%S\":[%u,%u,%u,%u,%u]"), (PGM_P) pgm_read_word(&wake_name[wake_index]), wake.count, WAKE_COUNTS_TO_USEC(wake.last), WAKE_COUNTS_TO_USEC(wake.max), wake.latency_last, wake.latency_max);
+        if (++wake_index < WAKE_SOURCES)
+        {
+            printf_P(PSTR(","));
+        }
+        else
+        {
+            printf_P(PSTR("}}\r\n"));
+            if (arg_count == 1) idle_reset();
+            initCommandBuffer();
+        }
+    }
+    else
+    {
+        initCommandBuffer();
+    }
+}
@@ -0,0 +1,6 @@
+#ifndef IsrLoop_H
+#define IsrLoop_H
+
+extern void IsrLoop(void);
+
+#endif // IsrLoop_H
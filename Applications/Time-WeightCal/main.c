@@ -0,0 +1,211 @@
+/*
+Time-WeightCal is a command line controled demonstration of gravimetric calibration timing
+Copyright (C) 2020 Ronald Sutherland
+
+Permission to use, copy, modify, and/or distribute this software for any purpose with or without fee is hereby granted.
+
+THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES 
+WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF 
+MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE 
+FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY 
+DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, 
+WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, 
+ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+https://en.wikipedia.org/wiki/BSD_licenses#0-clause_license_(%22Zero_Clause_BSD%22)
+*/
+
+#include <stdbool.h>
+#include <avr/pgmspace.h>
+#include <util/atomic.h>
+#include "../lib/timers_bsd.h"
+#include "../lib/uart0_bsd.h"
+#include "../lib/parse.h"
+#include "../lib/icp_bsd.h"
+#include "../lib/uart1_bsd.h"
+#include "../lib/idle_bsd.h"
+#include "../lib/twi0_bsd.h"
+#include "../lib/rpu_mgr.h"
+#include "../lib/io_enum_bsd.h"
+#include "../Uart/id.h"
+#include "graviton.h"
+#include "scale.h"
+#include "isrloop.h"
+
+#define BLINK_DELAY 1000UL
+static unsigned long blink_started_at;
+static unsigned long blink_delay;
+static char rpu_addr;
+
+void ProcessCmd()
+{ 
+    if ( (strcmp_P( command, PSTR("/id?")) == 0) && ( (arg_count == 0) || (arg_count == 1)) )
+    {
+        Id("Time-WeightCal");
+    }
+    if ( (strcmp_P( command, PSTR("/run?")) == 0) && (arg_count == 0) )
+    {
+        Run(); // graviton.c: wait for START and STOP then show the run integers
+    }
+    if ( (strcmp_P( command, PSTR("/flow?")) == 0) && (arg_count == 0) )
+    {
+        Flow(); // graviton.c: stream ICP1 events in binary frames
+    }
+    if ( (strcmp_P( command, PSTR("/frame?")) == 0) && ( (arg_count == 0) || (arg_count == 1)) )
+    {
+        FrameMode(); // graviton.c: reply with JSON text or binary frames
+    }
+    if ( (strcmp_P( command, PSTR("/scale?")) == 0) && ( (arg_count == 0) || (arg_count == 1)) )
+    {
+        Scale(); // scale.c: show the last scale reading and the time its line started
+    }
+    if ( (strcmp_P( command, PSTR("/isrloop?")) == 0) && ( (arg_count == 0) || (arg_count == 1)) )
+    {
+        IsrLoop(); // isrloop.c: show how often each ISR woke the MCU from idle sleep and the time to the main loop
+    }
+}
+
+// the loop has work while a ring buffer has data or a command is in process (unless it waits on a capture)
+static uint8_t loop_pending(void)
+{
+    if ( uart0_available() || uart1_available() || icp1_available() ) return 1;
+    return command_done && !GravitonWaiting();
+}
+
+void setup(void) 
+{
+    ioDir(MCU_IO_CS0_EN,DIRECTION_OUTPUT);
+    ioWrite(MCU_IO_CS0_EN,LOGIC_LEVEL_HIGH);
+    
+    // current sources for the ICP1 (FT), ICP3 (START), and ICP4 (STOP) loops
+    ioDir(MCU_IO_CS_ICP1,DIRECTION_OUTPUT);
+    ioWrite(MCU_IO_CS_ICP1,LOGIC_LEVEL_HIGH);
+    ioDir(MCU_IO_CS_ICP3,DIRECTION_OUTPUT);
+    ioWrite(MCU_IO_CS_ICP3,LOGIC_LEVEL_HIGH);
+    ioDir(MCU_IO_CS_ICP4,DIRECTION_OUTPUT);
+    ioWrite(MCU_IO_CS_ICP4,LOGIC_LEVEL_HIGH);
+
+    // Initialize Timers, and clear bootloader, Arduino does these with init() in wiring.c
+    initTimers(); //Timer0 Fast PWM mode, Timer2 Phase Correct PWM mode.
+    initIcp(); // Timer1, Timer3, Timer4 Normal mode /1 with input capture
+    icpDiversion(ICP_DIVERSION_ON_CAPTURE); // ICP3 (START) ISR turns CS_DIVERSION on and ICP4 (STOP) ISR turns it off
+    uart0_init(0,0); // bootloader may have the UART enabled, a zero baudrate will disconnect it.
+
+    /* Initialize UART to 38.4kbps, it returns a pointer to FILE so redirect of stdin and stdout works*/
+    stderr = stdout = stdin = uart0_init(38400UL, UART0_RX_REPLACE_CR_WITH_NL);
+    
+    /* Initialize UART1 for the scale */
+    ScaleInit();
+
+    /* Initialize I2C */
+    twi0_init(100000UL, TWI0_PINS_PULLUP);
+
+    /* Clear and setup the command buffer, (probably not needed at this point) */
+    initCommandBuffer();
+
+    // Enable global interrupts to start TIMER0 and UART ISR's
+    sei(); 
+    
+    // the loop sleeps when nothing is pending, any interrupt (the Timer0 tick at the latest) wakes it
+    idle_registerPending(loop_pending);
+
+    blink_started_at = milliseconds();
+    
+    rpu_addr = i2c_get_Rpu_address();
+    blink_delay = BLINK_DELAY;
+    
+    // blink fast if a default address from RPU manager not found
+    if (rpu_addr == 0)
+    {
+        rpu_addr = '0';
+        blink_delay = BLINK_DELAY/4;
+    }
+    else if (i2c_get_Rpu_mpcm() == RPU_MPCM_ON)
+    {
+        // the host sends rpu_addr as a 9 bit address frame, the UART hardware drops command lines for other nodes
+        uart0_mpcm_address(rpu_addr);
+        stderr = stdout = stdin = uart0_init(38400UL, UART0_RX_REPLACE_CR_WITH_NL | UART0_MPCM_ADDRESSING);
+    }
+}
+
+void blink(void)
+{
+    unsigned long kRuntime = elapsed(&blink_started_at);
+    if ( kRuntime > blink_delay)
+    {
+        ioToggle(MCU_IO_CS0_EN);
+        
+        // next toggle 
+        blink_started_at += blink_delay; 
+    }
+}
+
+int main(void) 
+{
+    setup();
+
+    while(1) 
+    { 
+        // use LED to show if I2C has a bus manager
+        blink();
+        
+        // check if character is available to assemble a command, e.g. non-blocking
+        if ( (!command_done) && uart0_available() ) // command_done is an extern from parse.h
+        {
+            // get a character from stdin and use it to assemble a command
+            AssembleCommand(getchar());
+
+            // address is an ascii value, warning: a null address would terminate the command string. 
+            StartEchoWhenAddressed(rpu_addr);
+        }
+        
+        // check if a character is available, and if so flush transmit buffer and nuke the command in process.
+        // A multi-drop bus can have another device start transmitting after getting an address byte so
+        // the first byte is used as a warning, it is the onlly chance to detect a possible collision.
+        // With MPCM addressing the bytes for another node are dropped by the hardware, so its address frame is the warning
+        // (it is read on every pass so one from befor the command does not count).
+        bool addressed_elsewhere = uart0_addressedElsewhere();
+        if ( command_done && (uart0_available() || addressed_elsewhere) )
+        {
+            // dump the transmit buffer to limit a collision 
+            uart0_empty(); 
+            initCommandBuffer();
+        }
+        
+        // flow pulses are buffered by the ICP1 ISR, drain them in batches
+        DrainFlowEvents();
+
+        // scale readings are lines on UART1
+        ScaleLine();
+          
+        // finish echo of the command line befor starting a reply (or the next part of a reply)
+        if ( command_done && uart0_availableForWrite() )
+        {
+            if ( !echo_on  )
+            { // this happons when the address did not match 
+                initCommandBuffer();
+            }
+            else
+            {
+                if (command_done == 1)  
+                {
+                    findCommand();
+                    command_done = 10;
+                }
+                
+                // do not overfill the serial buffer since that blocks looping, e.g. process a command in 32 byte chunks
+                if ( (command_done >= 10) && (command_done < 250) )
+                {
+                     ProcessCmd();
+                }
+                else 
+                {
+                    initCommandBuffer();
+                }
+            }
+         }
+
+        idle_sleep();
+    }        
+    return 0;
+}
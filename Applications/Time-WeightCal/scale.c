@@ -0,0 +1,106 @@
+/*
+Scale readings from UART1 with the capture time of the line
+Copyright (C) 2020 Ronald Sutherland
+
+Permission to use, copy, modify, and/or distribute this software for any purpose with or without fee is hereby granted.
+
+THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE
+FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY
+DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS,
+WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION,
+ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+https://en.wikipedia.org/wiki/BSD_licenses#0-clause_license_(%22Zero_Clause_BSD%22)
+*/
+
+#include <stdbool.h>
+#include <avr/pgmspace.h>
+#include <stdio.h>
+#include <stdlib.h>
+#include "../lib/parse.h"
+#include "../lib/icp_bsd.h"
+#include "../lib/uart1_bsd.h"
+#include "graviton.h"
+#include "scale.h"
+
+static FILE *scale_stream;
+
+// the line being assembled and the last complete line (reading) with its time
+static char scale_buf[SCALE_LINE_SIZE];
+static uint8_t scale_head;
+static bool scale_line_started; // the line has a byte that is not CR or NL (the UART1 ISR stamped it), even if none were kept
+static char scale_reading[SCALE_LINE_SIZE];
+static uint64_t scale_reading_at;
+static uint32_t scale_readings;
+
+// the scale is on UART1, each line is stamped with the capture time base so it lines up with ICP3/ICP4 events
+void ScaleInit(void)
+{
+    scale_stream = uart1_init(SCALE_BAUD, UART1_RX_REPLACE_CR_WITH_NL);
+    uart1_registerLineStamp(icpNow);
+}
+
+// assemble scale lines in the main loop, e.g. non-blocking
+void ScaleLine(void)
+{
+    while ( uart1_available() )
+    {
+        char input = (char) uart1_getchar(scale_stream);
+        if (input == '\n')
+        {
+            uint64_t stamp = 0;
+            if (scale_line_started)
+            {
+                // one stamp for each line that has something in it, zero if the stamp was lost
+                if (!uart1_lineStamp(&stamp)) stamp = 0;
+                scale_line_started = false;
+            }
+            if (scale_head)
+            {
+                scale_buf[scale_head] = '\0';
+                for (uint8_t i = 0; i <= scale_head; i++)
+                {
+                    scale_reading[i] = scale_buf[i];
+                }
+                scale_reading_at = stamp;
+                ++scale_readings;
+                scale_head = 0;
+            }
+        }
+        else
+        {
+            scale_line_started = true;
+            if ( (scale_head < (SCALE_LINE_SIZE - 1)) && (input >= ' ') && (input != '"') && (input != '\\') )
+            {
+                scale_buf[scale_head++] = input; // keep what is safe to put in a JSON string
+            }
+        }
+    }
+}
+
+/* show the last scale reading and its time, /scale? [request] sends a request (e.g. S) to the scale first */
+void Scale(void)
+{
+    if ( (command_done == 10) )
+    {
+        if (arg_count == 1)
+        {
+            fprintf_P(scale_stream, PSTR("%s\r\n"), arg[0]);
+        }
+        printf_P(PSTR("{\"scale\":\"%s\",\"n\":%lu"), scale_reading, scale_readings);
+        command_done = 11;
+    }
+    else if ( (command_done == 11) )
+    {
+        printf_P(PSTR(",\"at\":"));
+        PrintEventTime(scale_reading_at);
+        printf_P(PSTR("}\r\n"));
+        initCommandBuffer();
+    }
+    else
+    {
+        initCommandBuffer();
+    }
+}
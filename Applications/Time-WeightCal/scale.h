@@ -0,0 +1,11 @@
+#ifndef Scale_H
+#define Scale_H
+
+#define SCALE_BAUD 9600UL
+#define SCALE_LINE_SIZE 24
+
+extern void ScaleInit(void);
+extern void ScaleLine(void);
+extern void Scale(void);
+
+#endif // Scale_H
@@ -18,17 +18,34 @@ https://en.wikipedia.org/wiki/BSD_licenses#0-clause_license_(%22Zero_Clause_BSD%
 
 #include <util/atomic.h>
 #include "adc_bsd.h"
+#include "timers_bsd.h"
 
 volatile int adc[ADC_CHANNELS];
 volatile uint8_t adc_channel;
 volatile uint8_t ADC_auto_conversion;
 volatile uint8_t analog_reference;
 volatile uint8_t adc_isr_status;
+volatile uint32_t adc_burst_tick;
+volatile uint8_t adc_burst_count;
 
 static uint8_t free_running;
+static uint8_t trigger_ticks; // zero unless enable_ADC_timer_trigger was used
+static uint32_t trigger_due_tick;
 
 // Interrupt service routine for enable_ADC_auto_conversion
 ISR(ADC_vect){
+    wake_stamp(WAKE_ADC);
+    if ( trigger_ticks && (ADCSRA & (1<<ADATE)) )
+    {
+        // a Timer0 overflow started this conversion (ADATE is set on the tick befor one is due), only the one on the due tick starts a burst.
+        uint32_t now_tick = tickAtomic();
+        if ( ((int32_t)(now_tick - trigger_due_tick)) < 0 ) return;
+        trigger_due_tick += trigger_ticks;
+        if ( ((int32_t)(now_tick - trigger_due_tick)) >= 0 ) trigger_due_tick = now_tick + trigger_ticks; // fell behind
+        adc_burst_tick = now_tick;
+        adc_isr_status = ISR_ADCBURST_START;
+        ADCSRA &= ~(1<<ADATE); // the ISR starts the rest of the burst so an overflow can not start one on the wrong channel
+    }
     adc[adc_channel] = ADC;
     
     ++adc_channel;
@@ -36,6 +53,7 @@ ISR(ADC_vect){
     {
         adc_channel = 0;
         adc_isr_status = ISR_ADCBURST_DONE; // mark to notify burst is done
+        ++adc_burst_count;
     }
 
 #if defined(ADMUX)
@@ -57,7 +75,9 @@ ISR(ADC_vect){
     {
         ADCSRA |= (1<<ADSC);
         adc_isr_status = ISR_ADCBURST_START;
+        adc_burst_tick = tickAtomic();
     }
+    // with trigger_ticks the main loop sets ADATE again on the tick befor the next burst is due (arm_ADC_timer_trigger)
 }
 
 
@@ -135,6 +155,8 @@ void enable_ADC_auto_conversion(uint8_t free_run)
     adc_channel = 0;
     adc_isr_status = ISR_ADCBURST_START; // mark so we know new readings are arriving
     free_running = free_run;
+    trigger_ticks = 0;
+    adc_burst_tick = tickAtomic();
 
 #if defined(ADCSRA)
 	// Power up the ADC and set it for conversion with interrupts enabled
@@ -148,6 +170,71 @@ void enable_ADC_auto_conversion(uint8_t free_run)
     ADC_auto_conversion =1;
 }
 
+// Before setting the ADC Timer Trigger mode, use init_ADC_single_conversion 
+// to select reference and set the adc_clock pre-scaler. The Timer0 overflow (tick) is 
+// the auto trigger source, and a burst is started every ticks (1.024mSec at 16MHz, 1.365mSec at 12MHz), 
+// so the readings are evenly spaced no matter how long the main loop takes. The tick that started the last 
+// burst is from adcBurstTickAtomic, and adc_burst_count goes up by one when a burst is done. 
+// A burst has to be done before the next is due, e.g., eight channels take more than one tick.
+// Call arm_ADC_timer_trigger from the main loop, the auto trigger is only enabled on the tick befor a burst is due.
+void enable_ADC_timer_trigger(uint8_t ticks)
+{
+    if (!ticks) ticks = 1;
+    adc_channel = 0;
+    adc_isr_status = ISR_ADCBURST_DONE; // the first burst starts on the next overflow
+    free_running = 0;
+    trigger_ticks = ticks;
+    trigger_due_tick = tickAtomic() + 1;
+
+#if defined(ADCSRB) && defined(ADTS2)
+    // ADTS[2:0] set 0b100 auto trigger source is Timer/Counter0 Overflow
+    ADCSRB = (ADCSRB & ~((1<<ADTS2) | (1<<ADTS1) | (1<<ADTS0))) | (1<<ADTS2);
+#else
+#   error missing ADCSRB register which is used to select the auto trigger source
+#endif
+
+#if defined(ADCSRA)
+	// Power up the ADC with interrupts enabled, arm_ADC_timer_trigger sets ADATE when a burst is near
+    ADCSRA = ( (ADCSRA | (1<<ADEN) ) & ~(1<<ADATE) ) | (1 << ADIE);
+#else
+#   error missing ADCSRA register which has ADATE bit that is used to enable auto trigger
+#endif
+    ADC_auto_conversion =1;
+}
+
+// call from the main loop (at least once a tick) when enable_ADC_timer_trigger is used. 
+// ADATE is set only when the next Timer0 overflow makes the tick a burst is due on, so the overflows 
+// in between do not start a conversion (and an ISR) that would be thrown away. If the loop is late 
+// the burst starts on a later overflow and the ISR picks the next due tick from that one.
+void arm_ADC_timer_trigger(void)
+{
+    if (!trigger_ticks) return;
+    ATOMIC_BLOCK ( ATOMIC_RESTORESTATE )
+    {
+        if ( (adc_isr_status == ISR_ADCBURST_DONE) && !(ADCSRA & (1<<ADATE)) )
+        {
+            if ( ((int32_t)(tickAtomic() + 1 - trigger_due_tick)) >= 0 )
+            {
+                ADCSRA |= (1<<ADATE);
+            }
+        }
+    }
+}
+
+// return the tick that started the last burst, use atomic since the ISR changes it. 
+// The resolution is a tick (1.024mSec at 16MHz). With enable_ADC_timer_trigger the burst was started by the 
+// Timer0 overflow that made that tick, so it began at (tick << 8) in timer0CountsAtomic counts (within an ADC clock), 
+// with enable_ADC_auto_conversion it is the tick the ISR saw when it started the burst.
+uint32_t adcBurstTickAtomic(void)
+{
+    uint32_t local;
+    ATOMIC_BLOCK ( ATOMIC_RESTORESTATE )
+    {
+        local = adc_burst_tick;
+    }
+    return local;
+}
+
 // return two byes from the last ADC update, use atomic to make sure ISR does not change it durring read
 int adcAtomic(ADC_CH_t channel)
 {
@@ -69,5 +69,12 @@ extern int adcSingle(uint8_t channel);
 #define FREE_RUNNING 1
 #define BURST_MODE 0
 extern void enable_ADC_auto_conversion(uint8_t free_run);
+extern void enable_ADC_timer_trigger(uint8_t ticks);
+extern void arm_ADC_timer_trigger(void);
+
+// tick that started the last burst (read it with adcBurstTickAtomic), and a count of the bursts done (e.g., to see one was missed)
+extern volatile uint32_t adc_burst_tick;
+extern volatile uint8_t adc_burst_count;
+extern uint32_t adcBurstTickAtomic(void);
 
 #endif // AdcISR_h
@@ -0,0 +1,75 @@
+/*
+Dispatch a parsed command to its handler from a PROGMEM table
+Copyright (C) 2020 Ronald Sutherland
+
+Permission to use, copy, modify, and/or distribute this software for any purpose with or without fee is hereby granted.
+
+THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES 
+WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF 
+MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE 
+FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY 
+DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, 
+WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, 
+ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+https://en.wikipedia.org/wiki/BSD_licenses#0-clause_license_(%22Zero_Clause_BSD%22)
+
+A chain of strcmp_P in ProcessCmd() is done on each loop while a reply is sent in chunks. 
+The command is looked up once after findCommand(), and then each loop only calls the handler.
+*/
+#include <stddef.h>
+#include <avr/pgmspace.h>
+#include "parse.h"
+#include "dispatch.h"
+
+static void (*command_handler)(void);
+
+// same hash as DISPATCH_HASH() but at run time
+static uint16_t command_hash(const char *name)
+{
+    uint16_t hash = 0;
+    uint16_t weight = 1;
+    for (uint8_t i = 0; (i < (DISPATCH_NAME_SIZE - 1)) && (name[i] != '\0'); i++)
+    {
+        hash += (uint8_t)name[i] * weight;
+        weight *= 33;
+    }
+    return hash;
+}
+
+// find the handler for the command and argument count, returns 1 if found. 
+// If it is not found the command buffer is cleared.
+uint8_t resolveCommand(const DISPATCH_t *table, uint8_t size)
+{
+    command_handler = NULL;
+    if (command != NULL)
+    {
+        uint16_t hash = command_hash(command);
+        for (uint8_t i = 0; i < size; i++)
+        {
+            if ( (pgm_read_word(&table[i].hash) == hash) && \
+                (arg_count >= pgm_read_byte(&table[i].min_args)) && \
+                (arg_count <= pgm_read_byte(&table[i].max_args)) && \
+                (strcmp_P(command, table[i].name) == 0) )
+            {
+                command_handler = (void (*)(void)) pgm_read_word(&table[i].handler);
+                return 1;
+            }
+        }
+    }
+    initCommandBuffer();
+    return 0;
+}
+
+// run the handler that was found, it is called on each loop until the command is done
+void runCommand(void)
+{
+    if (command_handler != NULL)
+    {
+        command_handler();
+    }
+    else
+    {
+        initCommandBuffer();
+    }
+}
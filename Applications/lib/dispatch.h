@@ -0,0 +1,34 @@
+#ifndef DISPATCH_H
+#define DISPATCH_H
+
+#include <stdint.h>
+#include <avr/pgmspace.h>
+
+// a command name (e.g., "/dnmthresh?") with its null needs to fit 
+#define DISPATCH_NAME_SIZE 16
+
+// hash of the command name, sum of name[i] * 33^i (as uint16_t), the compiler folds it for a string literal
+#define DISPATCH_CHAR(s,i) ( ((i) < (sizeof(s) - 1)) ? (uint8_t)(s)[(i) < sizeof(s) ? (i) : 0] : 0u )
+#define DISPATCH_HASH(s) ((uint16_t)( DISPATCH_CHAR(s,0) + 33u*(DISPATCH_CHAR(s,1) + 33u*(DISPATCH_CHAR(s,2) + \
+    33u*(DISPATCH_CHAR(s,3) + 33u*(DISPATCH_CHAR(s,4) + 33u*(DISPATCH_CHAR(s,5) + 33u*(DISPATCH_CHAR(s,6) + \
+    33u*(DISPATCH_CHAR(s,7) + 33u*(DISPATCH_CHAR(s,8) + 33u*(DISPATCH_CHAR(s,9) + 33u*(DISPATCH_CHAR(s,10) + \
+    33u*(DISPATCH_CHAR(s,11) + 33u*(DISPATCH_CHAR(s,12) + 33u*(DISPATCH_CHAR(s,13) + 33u*(DISPATCH_CHAR(s,14) \
+    )))))))))))))) ))
+
+// an entry in a PROGMEM command table, the handler is run (in chunks) until it calls initCommandBuffer()
+typedef struct {
+    uint16_t hash;
+    char name[DISPATCH_NAME_SIZE];
+    uint8_t min_args;
+    uint8_t max_args;
+    void (*handler)(void);
+} DISPATCH_t;
+
+// e.g., static const DISPATCH_t cmd_table[] PROGMEM = { DISPATCH_CMD("/id?", 0, 1, IdCmd), ... };
+#define DISPATCH_CMD(name, min_args, max_args, handler) { DISPATCH_HASH(name), name, min_args, max_args, handler }
+#define DISPATCH_SIZE(table) ( (uint8_t) (sizeof(table) / sizeof(DISPATCH_t)) )
+
+extern uint8_t resolveCommand(const DISPATCH_t *table, uint8_t size);
+extern void runCommand(void);
+
+#endif // DISPATCH_H 
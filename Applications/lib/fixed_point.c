@@ -0,0 +1,73 @@
+/*
+Fixed point numbers to strings, e.g., 4985123 microvolts with two decimals is "4.99"
+Copyright (C) 2020 Ronald Sutherland
+
+Permission to use, copy, modify, and/or distribute this software for any purpose with or without fee is hereby granted.
+
+THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES 
+WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF 
+MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE 
+FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY 
+DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, 
+WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, 
+ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+https://en.wikipedia.org/wiki/BSD_licenses#0-clause_license_(%22Zero_Clause_BSD%22)
+
+This is used in place of printf "%1.2f" so the float version of vfprintf (-lprintf_flt) 
+is not needed. The string is used with printf "%s".
+*/
+#include <avr/pgmspace.h>
+#include "fixed_point.h"
+
+static const uint32_t pow10_table[] PROGMEM = {1UL, 10UL, 100UL, 1000UL, 10000UL, 100000UL, 1000000UL, 10000000UL, 100000000UL, 1000000000UL};
+
+// scale is 0..9 and decimals is not more than scale, the value is rounded half away from zero
+char *fixed_to_str(char *buf, int32_t value, uint8_t scale, uint8_t decimals)
+{
+    char digits[10];
+    uint8_t count = 0;
+    char *s = buf;
+    uint32_t magnitude;
+
+    if (value < 0)
+    {
+        *s++ = '-';
+        magnitude = -((uint32_t) value);
+    }
+    else
+    {
+        magnitude = (uint32_t) value;
+    }
+
+    if (scale > 9) scale = 9;
+    if (decimals > scale) decimals = scale;
+    uint32_t divisor = pgm_read_dword(&pow10_table[scale - decimals]);
+    if (divisor > 1)
+    {
+        uint32_t remainder = magnitude % divisor;
+        magnitude = magnitude / divisor;
+        if (remainder >= (divisor - (divisor>>1))) magnitude++;
+    }
+
+    // the 32 bit divide is slow, use it only until the value fits in 16 bits
+    while (magnitude > 0xFFFF)
+    {
+        digits[count++] = '0' + (magnitude % 10);
+        magnitude /= 10;
+    }
+    uint16_t small = (uint16_t) magnitude;
+    do
+    {
+        digits[count++] = '0' + (small % 10);
+        small /= 10;
+    } while ( small || (count <= decimals) );
+
+    while (count)
+    {
+        if (count == decimals) *s++ = '.';
+        *s++ = digits[--count];
+    }
+    *s = '\0';
+    return buf;
+}
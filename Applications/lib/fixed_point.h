@@ -0,0 +1,12 @@
+#ifndef Fixed_Point_H
+#define Fixed_Point_H
+
+#include <stdint.h>
+
+// room for a sign, ten digits, the decimal point, and a null
+#define FIXED_STR_SIZE 13
+
+// an integer in units of 10**-scale (e.g., microvolts are scale 6) shown with decimals places
+extern char *fixed_to_str(char *buf, int32_t value, uint8_t scale, uint8_t decimals);
+
+#endif // Fixed_Point_H 
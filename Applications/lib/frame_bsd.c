@@ -0,0 +1,77 @@
+/*
+Binary Frames for UART0 replies
+Copyright (C) 2020 Ronald Sutherland
+
+Permission to use, copy, modify, and/or distribute this software for any purpose with or without fee is hereby granted.
+
+THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE
+FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY
+DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS,
+WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION,
+ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+https://en.wikipedia.org/wiki/BSD_licenses#0-clause_license_(%22Zero_Clause_BSD%22)
+*/
+
+#include <util/crc16.h>
+#include "frame_bsd.h"
+
+uint8_t frame_mode = FRAME_MODE_TEXT;
+uint8_t frame_sequence;
+
+// the frame is built here and put in the transmit buffer as is (not through the stdio stream) since the payload is binary
+static uint8_t frame_buf[FRAME_PAYLOAD_MAX + FRAME_OVERHEAD];
+
+// send a frame if the transmit buffer has room for all of it, returns 1 if sent or 0 if the caller should try again on a later loop.
+// The sequence number goes up by one for each frame sent so the host can see a lost frame
+uint8_t frame_send(uint8_t type, const uint8_t *payload, uint8_t length)
+{
+    if (length > FRAME_PAYLOAD_MAX) length = FRAME_PAYLOAD_MAX; // frame_buf size
+    if (uart0_writeSpace() < (length + FRAME_OVERHEAD))
+    {
+        return 0; // nothing was sent, so the frame is never split
+    }
+    uint8_t used = 0;
+    frame_buf[used++] = FRAME_SYNC;
+    frame_buf[used++] = length;
+    frame_buf[used++] = frame_sequence++;
+    frame_buf[used++] = type;
+    for (uint8_t i = 0; i < length; i++)
+    {
+        frame_buf[used++] = payload[i];
+    }
+    uint16_t crc = 0xFFFF;
+    for (uint8_t i = 1; i < used; i++)
+    {
+        crc = _crc_ccitt_update(crc, frame_buf[i]);
+    }
+    frame_buf[used++] = (uint8_t) (crc & 0xFF);
+    frame_buf[used++] = (uint8_t) (crc >> 8);
+    uart0_write(frame_buf, used); // takes all of it since the space was checked
+    return 1;
+}
+
+// pack little endian numbers into a payload, return the number of bytes used
+uint8_t frame_pack_u16(uint8_t *buf, uint16_t value)
+{
+    buf[0] = (uint8_t) value;
+    buf[1] = (uint8_t) (value >> 8);
+    return 2;
+}
+
+uint8_t frame_pack_u32(uint8_t *buf, uint32_t value)
+{
+    frame_pack_u16(buf, (uint16_t) value);
+    frame_pack_u16(buf + 2, (uint16_t) (value >> 16));
+    return 4;
+}
+
+// a 46 bit event time fits in six bytes
+uint8_t frame_pack_u48(uint8_t *buf, uint64_t value)
+{
+    frame_pack_u32(buf, (uint32_t) value);
+    frame_pack_u16(buf + 4, (uint16_t) (value >> 32));
+    return 6;
+}
@@ -0,0 +1,28 @@
+#ifndef Frame_H
+#define Frame_H
+
+#include <stdbool.h>
+#include <stdint.h>
+#include "uart0_bsd.h"
+
+// Binary frame on UART0: SYNC, length, sequence, type, payload[length], CRC16 (low byte first).
+// The CRC is CCITT (avr-libc _crc_ccitt_update, 0xFFFF start) over length, sequence, type, and payload.
+// Numbers in the payload are little endian.
+#define FRAME_SYNC 0x7E
+#define FRAME_OVERHEAD 6
+
+// a frame of this size fits in the UART0 transmit buffer, frame_send returns 0 (not sent) until there is room for all of it
+#define FRAME_PAYLOAD_MAX (UART0_TX0_SIZE - 1 - FRAME_OVERHEAD)
+
+// replies are JSON text (FRAME_MODE_TEXT) or binary frames (FRAME_MODE_BINARY), commands are always text
+#define FRAME_MODE_TEXT 0
+#define FRAME_MODE_BINARY 1
+extern uint8_t frame_mode;
+extern uint8_t frame_sequence;
+
+extern uint8_t frame_send(uint8_t type, const uint8_t *payload, uint8_t length);
+extern uint8_t frame_pack_u16(uint8_t *buf, uint16_t value);
+extern uint8_t frame_pack_u32(uint8_t *buf, uint32_t value);
+extern uint8_t frame_pack_u48(uint8_t *buf, uint64_t value);
+
+#endif // Frame_H
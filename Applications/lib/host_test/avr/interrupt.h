@@ -0,0 +1,11 @@
+#ifndef HostTest_Interrupt_h
+#define HostTest_Interrupt_h
+
+#include <avr/io.h>
+
+// an ISR is a function the test can call
+#define ISR(vector) void vector(void)
+#define sei()
+#define cli()
+
+#endif // HostTest_Interrupt_h
@@ -0,0 +1,48 @@
+#ifndef HostTest_Io_h
+#define HostTest_Io_h
+
+// registers are an array the test owns so the AVR source builds on the host
+
+#include <stdint.h>
+
+extern uint8_t host_reg[15];
+#define TCCR0A host_reg[0]
+#define TCCR0B host_reg[1]
+#define TCCR1A host_reg[2]
+#define TCCR1B host_reg[3]
+#define TCCR2A host_reg[4]
+#define TCCR2B host_reg[5]
+#define TCCR3A host_reg[6]
+#define TCCR3B host_reg[7]
+#define TCCR4A host_reg[8]
+#define TCCR4B host_reg[9]
+#define TCCR5A host_reg[10]
+#define TCCR5B host_reg[11]
+#define TCNT0 host_reg[12]
+#define TIFR0 host_reg[13]
+#define TIMSK0 host_reg[14]
+
+#define WGM00 0
+#define WGM01 1
+#define WGM02 3
+#define WGM10 0
+#define WGM20 0
+#define WGM30 0
+#define WGM40 0
+#define WGM50 0
+#define CS00 0
+#define CS01 1
+#define CS02 2
+#define CS10 0
+#define CS11 1
+#define CS22 2
+#define CS30 0
+#define CS31 1
+#define CS40 0
+#define CS41 1
+#define CS50 0
+#define CS51 1
+#define TOV0 0
+#define TOIE0 0
+
+#endif // HostTest_Io_h
@@ -0,0 +1,125 @@
+/*
+host test of milliseconds() from timers_bsd.c against the per tick loop it replaced
+
+Copyright (C) 2026 Ronald Sutherland
+
+Permission to use, copy, modify, and/or distribute this software for any
+purpose with or without fee is hereby granted.
+
+THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE FOR
+ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY DAMAGES
+WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, WHETHER IN AN
+ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, ARISING OUT OF
+OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+https://en.wikipedia.org/wiki/BSD_licenses#0-clause_license_(%22Zero_Clause_BSD%22)
+
+The Makefile builds this with F_CPU and TIMERS_SRC set, e.g., the application or manager timers_bsd.c
+*/
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include TIMERS_SRC
+
+uint8_t host_reg[15];
+
+// the loop milliseconds() used befor, with its 250 tick cap removed (it is the same code for calls 250 ticks or less apart)
+static uint32_t loop_tick_last_used;
+static uint16_t loop_uS_balance;
+static uint32_t loop_millisec; // unsigned long is 32 bits on the AVR
+
+static uint32_t loop_milliseconds(void)
+{
+    uint32_t now_tick = tick;
+    uint32_t ktick = now_tick - loop_tick_last_used;
+    while (ktick)
+    {
+        ++loop_millisec;
+        loop_uS_balance += MICROSEC_TICK_CORRECTION;
+        if (loop_uS_balance > 1000)
+        {
+            ++loop_millisec;
+            loop_uS_balance -= 1000;
+        }
+        --ktick;
+    }
+    loop_tick_last_used = now_tick;
+    return loop_millisec;
+}
+
+// both start from the same tick, balance and millisecond count
+static void start_at(uint32_t start_tick, uint16_t balance, unsigned long ms)
+{
+    tick = start_tick;
+    millisec_tick_last_used = loop_tick_last_used = start_tick;
+    uS_balance = loop_uS_balance = balance;
+    millisec = loop_millisec = ms;
+}
+
+// advance tick by random steps up to max_step until steps calls are checked, return the number of mismatches
+static unsigned long run(const char *name, unsigned long steps, uint32_t max_step, int quiet)
+{
+    unsigned long bad = 0;
+    for (unsigned long i = 0; i < steps; ++i)
+    {
+        tick += (uint32_t) (((uint64_t) rand() * rand()) % ((uint64_t) max_step + 1));
+        uint32_t ms = (uint32_t) milliseconds();
+        uint32_t loop_ms = loop_milliseconds();
+        if ((ms != loop_ms) || (uS_balance != loop_uS_balance))
+        {
+            if (bad < 5) printf("%s: tick %lu ms %lu balance %u, loop ms %lu balance %u\n", name, 
+                (unsigned long) tick, (unsigned long) ms, uS_balance, (unsigned long) loop_ms, loop_uS_balance);
+            ++bad;
+        }
+    }
+    if (!quiet) printf("%s: %lu calls, %lu mismatch\n", name, steps, bad);
+    return bad;
+}
+
+int main(void)
+{
+    unsigned long bad = 0;
+    srand(1);
+    printf("F_CPU %lu, MICROSEC_TICK_CORRECTION %lu\n", (unsigned long) F_CPU, (unsigned long) MICROSEC_TICK_CORRECTION);
+
+    // calls a tick apart or less, and up to the 250 ticks the old loop allowed
+    start_at(0, 0, 0);
+    bad += run("every tick", 200000, 1, 0);
+    start_at(0, 0, 0);
+    bad += run("up to 250 ticks", 200000, 250, 0);
+
+    // long blocking sections, the old loop lost time past 250 ticks
+    start_at(0, 0, 0);
+    bad += run("up to 100000 ticks", 20000, 100000, 0);
+
+    // start from each balance the loop can hold
+    unsigned long balance_bad = 0;
+    for (uint16_t balance = 0; balance <= 1000; ++balance)
+    {
+        start_at(12345, balance, 777);
+        balance_bad += run("balance", 50, 3000, 1);
+    }
+    printf("each balance 0..1000: %lu mismatch\n", balance_bad);
+    bad += balance_bad;
+
+    // the tick rolls over after 2**32 counts (50.9 days at 16MHz)
+    start_at(0xFFFFFFFFUL - 50000UL, 500, 0xFFFFF000UL);
+    bad += run("tick rollover", 1000, 250, 0);
+    start_at(0xFFFFFFFFUL - 50000UL, 999, 0xFFFFF000UL);
+    bad += run("tick rollover long steps", 100, 5000, 0);
+
+    // a single call after a full 2**32 - 1 ticks
+    start_at(1, 1000, 0);
+    tick = 0;
+    if (((uint32_t) milliseconds() != loop_milliseconds()) || (uS_balance != loop_uS_balance)) 
+    {
+        printf("2**32 - 1 ticks: mismatch\n");
+        ++bad;
+    }
+    else printf("2**32 - 1 ticks: match\n");
+
+    printf("%s\n", bad ? "FAIL" : "PASS");
+    return bad ? 1 : 0;
+}
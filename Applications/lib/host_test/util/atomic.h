@@ -0,0 +1,8 @@
+#ifndef HostTest_Atomic_h
+#define HostTest_Atomic_h
+
+// the test has no interrupts, so the block just runs once
+#define ATOMIC_RESTORESTATE 0
+#define ATOMIC_BLOCK(type) for (uint8_t atomic_once = 1; atomic_once; atomic_once = 0)
+
+#endif // HostTest_Atomic_h
@@ -0,0 +1,424 @@
+/*
+Interrupt-Driven Input Capture with 46 bit Event Time
+Copyright (C) 2020 Ronald Sutherland
+
+Permission to use, copy, modify, and/or distribute this software for any purpose with or without fee is hereby granted.
+
+THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES
+WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF
+MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE
+FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY
+DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS,
+WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION,
+ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+https://en.wikipedia.org/wiki/BSD_licenses#0-clause_license_(%22Zero_Clause_BSD%22)
+*/
+
+#include <util/atomic.h>
+#include <avr/interrupt.h>
+#include "icp_bsd.h"
+#include "timers_bsd.h"
+#include "io_enum_bsd.h"
+
+volatile uint64_t icp_event[ICP_CHANNELS];
+volatile uint32_t icp_event_count[ICP_CHANNELS];
+
+// ICP1 ring buffer, the capture ISR is the only writer of Icp1Head and the main loop is the only writer of Icp1Tail
+static volatile uint64_t Icp1Buf[ICP1_BUF_SIZE];
+static volatile uint8_t Icp1Head;
+static volatile uint8_t Icp1Tail;
+static volatile uint16_t icp1_buf_overflow; // count of events that did not fit, e.g., were lost
+static volatile uint8_t icp1_buf_high_water; // most events that have been waiting in the buffer
+
+static volatile ICP_SNAPSHOT_t icp_snapshot[ICP_SNAPSHOTS];
+static volatile uint8_t icp_diversion_control;
+
+// each timer has its own overflow count, they start at zero together and roll over together
+static volatile uint32_t icp_overflow[ICP_CHANNELS];
+
+// Merge a 16 bit capture with the overflow count of its timer.
+// The overflow ISR can not run while a capture ISR is running, so the overflow may be pending (TOVn set).
+// A pending overflow with a capture in the lower half of the count means the capture happened after
+// the timer rolled over, so it goes with the next overflow count. A capture in the upper half happened
+// before the roll over. This is correct as long as no ISR blocks for more than half a timer period (2mSec).
+static inline __attribute__((always_inline)) uint64_t icp_merge(uint32_t overflow, uint16_t capture, uint8_t tov_pending)
+{
+    if (tov_pending && (capture < 0x8000))
+    {
+        ++overflow;
+    }
+    return ( ((uint64_t) (overflow & ICP_OVERFLOW_MASK)) << 16 ) | capture;
+}
+
+// ICP1 capture is used by its own ISR and by the ICP3/ICP4 ISRs when it is pending
+static inline __attribute__((always_inline)) void icp1_capture(uint16_t capture)
+{
+    uint64_t event = icp_merge(icp_overflow[ICP_CH_ICP1], capture, TIFR1 & (1<<TOV1));
+    icp_event[ICP_CH_ICP1] = event;
+    ++icp_event_count[ICP_CH_ICP1];
+
+    uint8_t next_index = (Icp1Head + 1) & (ICP1_BUF_SIZE - 1);
+    uint8_t tail = Icp1Tail;
+    if (next_index == tail)
+    {
+        ++icp1_buf_overflow;
+    }
+    else
+    {
+        Icp1Buf[next_index] = event;
+        Icp1Head = next_index;
+        uint8_t used = (ICP1_BUF_SIZE + next_index - tail) & (ICP1_BUF_SIZE - 1);
+        if (used > icp1_buf_high_water) icp1_buf_high_water = used;
+    }
+}
+
+// Snapshot the ICP1 count and recent ICP1 events at a START or STOP event.
+// The ring slots behind the head keep their events until the ISR wraps around to them,
+// a main loop drain only moves the tail. If ICP1 events were lost the snapshot is stale (see icp1_overflowAtomic).
+static inline __attribute__((always_inline)) void icp_snapshot_take(ICP_SNAP_t which, uint64_t event)
+{
+    // an ICP1 capture that is pending was latched before now, take it into the buffer so the snapshot is current.
+    // ICF1 can not be read and cleared in one step, a capture after ICR1 is read and befor ICF1 is cleared would be lost, 
+    // so ICR1 is read again after the clear. If it changed and ICF1 is still clear that capture is taken as well, 
+    // if ICF1 is set again the capture came after the clear and the TIMER1_CAPT ISR takes it when this ISR is done.
+    if (TIFR1 & (1<<ICF1))
+    {
+        uint16_t capture = ICR1;
+        TIFR1 = (1<<ICF1);
+        uint16_t recapture = ICR1;
+        icp1_capture(capture);
+        if ( (recapture != capture) && !(TIFR1 & (1<<ICF1)) )
+        {
+            icp1_capture(recapture);
+        }
+    }
+
+    uint32_t count = icp_event_count[ICP_CH_ICP1];
+    uint8_t history = ICP1_BUF_SIZE - 1;
+    if (count < history) history = (uint8_t) count;
+    uint8_t index = Icp1Head;
+    uint8_t recent = 0;
+    volatile ICP_SNAPSHOT_t *snap = &icp_snapshot[which];
+    while (history && (recent < ICP1_SNAPSHOT_SIZE))
+    {
+        uint64_t icp1_event = Icp1Buf[index];
+        if ( ((event - icp1_event) & ICP_EVENT_MASK) & ~(ICP_EVENT_MASK>>1) )
+        {
+            --count; // after the event (e.g., the difference is negative), so it does not belong to the snapshot
+        }
+        else
+        {
+            snap->icp1_recent[recent++] = icp1_event;
+        }
+        index = (index - 1) & (ICP1_BUF_SIZE - 1);
+        --history;
+    }
+    snap->event = event;
+    snap->icp1_count = count;
+    snap->icp1_recent_count = recent;
+}
+
+ISR(TIMER1_CAPT_vect)
+{
+    wake_stamp_latency(WAKE_CAPTURE, TCNT1 - ICR1);
+    icp1_capture(ICR1);
+}
+
+// record when CS_DIVERSION was changed, the timer count after the change is less than a timer period from the capture
+static inline __attribute__((always_inline)) void icp_diversion_record(ICP_SNAP_t which, uint64_t event, uint16_t capture, uint16_t changed_at)
+{
+    volatile ICP_SNAPSHOT_t *snap = &icp_snapshot[which];
+    if (icp_diversion_control)
+    {
+        uint16_t latency = changed_at - capture;
+        snap->diversion = (event + latency) & ICP_EVENT_MASK;
+        snap->diversion_latency = latency;
+    }
+    else
+    {
+        snap->diversion = 0;
+        snap->diversion_latency = 0;
+    }
+}
+
+ISR(TIMER3_CAPT_vect)
+{
+    // START turns diversion on, do it before anything else so the latency is short and does not vary with the work below
+    uint16_t changed_at = 0;
+    if (icp_diversion_control)
+    {
+        ioWrite(MCU_IO_CS_DIVERSION, LOGIC_LEVEL_HIGH);
+        changed_at = TCNT3;
+    }
+    wake_stamp_latency(WAKE_CAPTURE, TCNT3 - ICR3); // after the diversion change so it does not add to that latency (the wake latency includes it)
+    uint16_t capture = ICR3;
+    uint64_t event = icp_merge(icp_overflow[ICP_CH_ICP3], capture, TIFR3 & (1<<TOV3));
+    icp_event[ICP_CH_ICP3] = event;
+    ++icp_event_count[ICP_CH_ICP3];
+    icp_snapshot_take(ICP_SNAP_START, event);
+    icp_diversion_record(ICP_SNAP_START, event, capture, changed_at);
+}
+
+ISR(TIMER4_CAPT_vect)
+{
+    // STOP turns diversion off
+    uint16_t changed_at = 0;
+    if (icp_diversion_control)
+    {
+        ioWrite(MCU_IO_CS_DIVERSION, LOGIC_LEVEL_LOW);
+        changed_at = TCNT4;
+    }
+    wake_stamp_latency(WAKE_CAPTURE, TCNT4 - ICR4);
+    uint16_t capture = ICR4;
+    uint64_t event = icp_merge(icp_overflow[ICP_CH_ICP4], capture, TIFR4 & (1<<TOV4));
+    icp_event[ICP_CH_ICP4] = event;
+    ++icp_event_count[ICP_CH_ICP4];
+    icp_snapshot_take(ICP_SNAP_STOP, event);
+    icp_diversion_record(ICP_SNAP_STOP, event, capture, changed_at);
+}
+
+ISR(TIMER1_OVF_vect)
+{
+    // swap to local since volatile has to be read from memory on every access
+    uint32_t local_overflow = icp_overflow[ICP_CH_ICP1];
+    ++local_overflow;
+    icp_overflow[ICP_CH_ICP1] = local_overflow;
+}
+
+ISR(TIMER3_OVF_vect)
+{
+    uint32_t local_overflow = icp_overflow[ICP_CH_ICP3];
+    ++local_overflow;
+    icp_overflow[ICP_CH_ICP3] = local_overflow;
+}
+
+ISR(TIMER4_OVF_vect)
+{
+    uint32_t local_overflow = icp_overflow[ICP_CH_ICP4];
+    ++local_overflow;
+    icp_overflow[ICP_CH_ICP4] = local_overflow;
+}
+
+/* setup Timer1, Timer3, Timer4: /1 Normal mode with input capture (ICP1, ICP3, ICP4)
+   this replaces the PWM setup that initTimers() did for these timers */
+void initIcp(void)
+{
+#if defined(TCCR1B) && defined(TCCR3B) && defined(TCCR4B) && defined(ICNC1) && defined(CS10)
+    ATOMIC_BLOCK ( ATOMIC_RESTORESTATE )
+    {
+        // CSn[2:0] set 0b000 to stop the timers
+        TCCR1B = 0;
+        TCCR3B = 0;
+        TCCR4B = 0;
+
+        // COMnA[1:0] and COMnB[1:0] set OCnA/OCnB disconnected. WGMn[3:0] set 0b0000 Normal Mode
+        TCCR1A = 0;
+        TCCR3A = 0;
+        TCCR4A = 0;
+
+        // the timers are started one after the other (each sts is two clocks), preload the later ones so the counts match
+        TCNT1 = 0;
+        TCNT3 = 2;
+        TCNT4 = 4;
+        for (uint8_t channel = 0; channel < ICP_CHANNELS; channel++)
+        {
+            icp_overflow[channel] = 0;
+            icp_event[channel] = 0;
+            icp_event_count[channel] = 0;
+        }
+        for (uint8_t which = 0; which < ICP_SNAPSHOTS; which++)
+        {
+            icp_snapshot[which].event = 0;
+            icp_snapshot[which].icp1_count = 0;
+            icp_snapshot[which].icp1_recent_count = 0;
+            icp_snapshot[which].diversion = 0;
+            icp_snapshot[which].diversion_latency = 0;
+        }
+        Icp1Head = 0;
+        Icp1Tail = 0;
+        icp1_buf_overflow = 0;
+        icp1_buf_high_water = 0;
+
+        // clear pending flags (write a one to clear) and enable capture and overflow interrupts
+        TIFR1 = (1<<ICF1) | (1<<TOV1);
+        TIFR3 = (1<<ICF3) | (1<<TOV3);
+        TIFR4 = (1<<ICF4) | (1<<TOV4);
+        TIMSK1 = (1<<ICIE1) | (1<<TOIE1);
+        TIMSK3 = (1<<ICIE3) | (1<<TOIE3);
+        TIMSK4 = (1<<ICIE4) | (1<<TOIE4);
+
+        // ICNCn set to enable the noise canceler, ICESn clear for falling edge, CSn[2:0] set 0b001 clk/1
+        uint8_t start = (1<<ICNC1) | (1<<CS10);
+
+        // the order and timing of the start has to be known, so do not let the compiler pick it
+        __asm__ __volatile__ (
+            "sts %0, %3" "\n\t"
+            "sts %1, %3" "\n\t"
+            "sts %2, %3" "\n\t"
+            :
+            : "n" (_SFR_MEM_ADDR(TCCR1B)), "n" (_SFR_MEM_ADDR(TCCR3B)), "n" (_SFR_MEM_ADDR(TCCR4B)), "r" (start)
+        );
+    }
+#else
+    #error Timer1, Timer3, and Timer4 input capture not available
+#endif
+}
+
+// select the edge that captures an event
+void icpEdge(ICP_CH_t channel, ICP_EDGE_t edge)
+{
+    ATOMIC_BLOCK ( ATOMIC_RESTORESTATE )
+    {
+        // changing the edge may set ICFn, so clear it after the change
+        switch (channel)
+        {
+            case ICP_CH_ICP1:
+                if (edge == ICP_EDGE_RISING) TCCR1B |= (1<<ICES1);
+                else TCCR1B &= ~(1<<ICES1);
+                TIFR1 = (1<<ICF1);
+                break;
+            case ICP_CH_ICP3:
+                if (edge == ICP_EDGE_RISING) TCCR3B |= (1<<ICES3);
+                else TCCR3B &= ~(1<<ICES3);
+                TIFR3 = (1<<ICF3);
+                break;
+            case ICP_CH_ICP4:
+                if (edge == ICP_EDGE_RISING) TCCR4B |= (1<<ICES4);
+                else TCCR4B &= ~(1<<ICES4);
+                TIFR4 = (1<<ICF4);
+                break;
+            default:
+                break;
+        }
+    }
+}
+
+// return the 46 bit time of the last event, use atomic to make sure ISR does not change it durring read
+uint64_t icpEventAtomic(ICP_CH_t channel)
+{
+    uint64_t x = 0;
+    if (channel < ICP_CHANNELS)
+    {
+        ATOMIC_BLOCK ( ATOMIC_RESTORESTATE )
+        {
+            x = icp_event[channel];
+        }
+    }
+    return x;
+}
+
+// return the count of events
+uint32_t icpCountAtomic(ICP_CH_t channel)
+{
+    uint32_t x = 0;
+    if (channel < ICP_CHANNELS)
+    {
+        ATOMIC_BLOCK ( ATOMIC_RESTORESTATE )
+        {
+            x = icp_event_count[channel];
+        }
+    }
+    return x;
+}
+
+// return the 46 bit time now, e.g., to compare with an event time
+uint64_t icpNow(void)
+{
+    uint16_t count;
+    uint32_t overflow;
+    uint8_t tov_pending;
+    ATOMIC_BLOCK ( ATOMIC_RESTORESTATE )
+    {
+        count = TCNT1;
+        overflow = icp_overflow[ICP_CH_ICP1];
+        tov_pending = TIFR1 & (1<<TOV1);
+    }
+    return icp_merge(overflow, count, tov_pending);
+}
+
+// Number of ICP1 events waiting in the buffer.
+uint8_t icp1_available(void)
+{
+    return (ICP1_BUF_SIZE + Icp1Head - Icp1Tail) & (ICP1_BUF_SIZE - 1);
+}
+
+// Drain up to max ICP1 events (oldest first) into events[], returns the number copied.
+// Only the main loop should call this, the ISR does not touch the tail.
+uint8_t icp1_read(uint64_t *events, uint8_t max)
+{
+    uint8_t head = Icp1Head; // a single byte read is atomic, events after this are left for the next batch
+    uint8_t tail = Icp1Tail;
+    uint8_t copied = 0;
+    while ( (tail != head) && (copied < max) )
+    {
+        // the ISR will not write a slot until Icp1Tail has moved past it, so no atomic block is needed
+        tail = (tail + 1) & (ICP1_BUF_SIZE - 1);
+        events[copied++] = Icp1Buf[tail];
+    }
+    Icp1Tail = tail; // free the slots for the ISR
+    return copied;
+}
+
+// count of ICP1 events lost because the buffer was full
+uint16_t icp1_overflowAtomic(void)
+{
+    uint16_t x;
+    ATOMIC_BLOCK ( ATOMIC_RESTORESTATE )
+    {
+        x = icp1_buf_overflow;
+    }
+    return x;
+}
+
+// most ICP1 events that have been waiting at once, if it reaches ICP1_BUF_SIZE-1 events may have been lost
+uint8_t icp1_high_water(void)
+{
+    return icp1_buf_high_water;
+}
+
+// discard waiting ICP1 events and clear the overflow count and high water mark, e.g., at the start of a run
+void icp1_reset_buffer(void)
+{
+    ATOMIC_BLOCK ( ATOMIC_RESTORESTATE )
+    {
+        Icp1Tail = Icp1Head;
+        icp1_buf_overflow = 0;
+        icp1_buf_high_water = 0;
+    }
+}
+
+// copy the START or STOP snapshot, use atomic to make sure ISR does not change it durring the copy
+void icpSnapshotAtomic(ICP_SNAP_t which, ICP_SNAPSHOT_t *snapshot)
+{
+    if (which < ICP_SNAPSHOTS)
+    {
+        ATOMIC_BLOCK ( ATOMIC_RESTORESTATE )
+        {
+            snapshot->event = icp_snapshot[which].event;
+            snapshot->icp1_count = icp_snapshot[which].icp1_count;
+            snapshot->icp1_recent_count = icp_snapshot[which].icp1_recent_count;
+            snapshot->diversion = icp_snapshot[which].diversion;
+            snapshot->diversion_latency = icp_snapshot[which].diversion_latency;
+            for (uint8_t i = 0; i < ICP1_SNAPSHOT_SIZE; i++)
+            {
+                snapshot->icp1_recent[i] = icp_snapshot[which].icp1_recent[i];
+            }
+        }
+    }
+}
+
+// Let the ICP3 (START) and ICP4 (STOP) ISRs control CS_DIVERSION (ICP_DIVERSION_ON_CAPTURE), or leave it to the application.
+// CS_DIVERSION on PC6 is not an output compare pin, so the ISR has to change it.
+void icpDiversion(uint8_t control)
+{
+    ATOMIC_BLOCK ( ATOMIC_RESTORESTATE )
+    {
+        if (control == ICP_DIVERSION_ON_CAPTURE)
+        {
+            ioWrite(MCU_IO_CS_DIVERSION, LOGIC_LEVEL_LOW);
+            ioDir(MCU_IO_CS_DIVERSION, DIRECTION_OUTPUT);
+        }
+        icp_diversion_control = control;
+    }
+}
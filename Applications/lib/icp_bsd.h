@@ -0,0 +1,79 @@
+#ifndef IcpISR_h
+#define IcpISR_h
+
+#include <stdint.h>
+
+// Input capture on Timer1 (ICP1), Timer3 (ICP3), and Timer4 (ICP4).
+// The timers are clocked from the crystal with no prescale, so a capture has one crystal count resolution.
+// The 16 bit capture is merged with a count of the timer overflows to form a 46 bit event time.
+// The three timers are started together so all event times are in one time domain.
+// (2**46)/16000000/3600/24 = 50.9 days before the event time rolls over (same as tick).
+
+// enumeraiton names for ICP_CH_<node> from schematic
+typedef enum ICP_CH_enum {
+    ICP_CH_ICP1, // PD6 is input capture of Timer1, e.g., flow meter (FT) events
+    ICP_CH_ICP3, // PB5 is input capture of Timer3, e.g., START event
+    ICP_CH_ICP4, // PC3 is input capture of Timer4, e.g., STOP event
+    ICP_CHANNELS
+} ICP_CH_t;
+
+// the ICP pins are inverted from the plug interface, loop current makes the pin LOW
+typedef enum ICP_EDGE_enum {
+    ICP_EDGE_FALLING, // loop current turned on
+    ICP_EDGE_RISING // loop current turned off
+} ICP_EDGE_t;
+
+#define ICP_OVERFLOW_MASK 0x3FFFFFFFUL
+#define ICP_EVENT_MASK 0x3FFFFFFFFFFFULL
+
+// the noise canceler (ICNC) delays each capture by four crystal counts, it is the same for all channels.
+#define ICP_NOISE_CANCELER_DELAY 4
+
+// ICP1 events are also held in a ring buffer that the main loop drains in batches.
+// Buffer size: (1<<5), (1<<4), (1<<3), (1<<2). One slot is kept open, so it holds size-1 events.
+#ifndef ICP1_BUF_SIZE
+#define ICP1_BUF_SIZE (1<<5)
+#endif
+
+// The ICP3 (START) and ICP4 (STOP) ISRs take a snapshot of the ICP1 count and the most recent ICP1 events.
+// A pending ICP1 capture is taken into the buffer first, and ICP1 events after the START/STOP are left out.
+#define ICP1_SNAPSHOT_SIZE 8
+typedef enum ICP_SNAP_enum {
+    ICP_SNAP_START, // taken at the ICP3 event
+    ICP_SNAP_STOP, // taken at the ICP4 event
+    ICP_SNAPSHOTS
+} ICP_SNAP_t;
+
+typedef struct {
+    uint64_t event; // ICP3 or ICP4 event time
+    uint32_t icp1_count; // ICP1 events that happened before the event
+    uint8_t icp1_recent_count; // number of valid icp1_recent[] entries
+    uint64_t icp1_recent[ICP1_SNAPSHOT_SIZE]; // ICP1 event times with the newest in [0]
+    uint64_t diversion; // time CS_DIVERSION was changed by the ISR (zero when diversion control is off)
+    uint16_t diversion_latency; // crystal counts from the capture to the CS_DIVERSION change
+} ICP_SNAPSHOT_t;
+
+// Diversion control: the ICP3 ISR sets CS_DIVERSION and the ICP4 ISR clears it, it is done first thing in the ISR.
+// The board holds diversion on during the START one-shot and off during the STOP one-shot (~1.1mSec),
+// so the ISR change needs to happen before the one-shot ends. The latency is measured with the capture timer.
+#define ICP_DIVERSION_OFF 0
+#define ICP_DIVERSION_ON_CAPTURE 1
+
+extern volatile uint64_t icp_event[];
+extern volatile uint32_t icp_event_count[];
+
+extern void initIcp(void);
+extern void icpEdge(ICP_CH_t channel, ICP_EDGE_t edge);
+extern uint64_t icpEventAtomic(ICP_CH_t channel);
+extern uint32_t icpCountAtomic(ICP_CH_t channel);
+extern uint64_t icpNow(void);
+
+extern uint8_t icp1_available(void);
+extern uint8_t icp1_read(uint64_t *events, uint8_t max);
+extern uint16_t icp1_overflowAtomic(void);
+extern uint8_t icp1_high_water(void);
+extern void icp1_reset_buffer(void);
+extern void icpSnapshotAtomic(ICP_SNAP_t which, ICP_SNAPSHOT_t *snapshot);
+extern void icpDiversion(uint8_t control);
+
+#endif // IcpISR_h
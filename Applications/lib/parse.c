@@ -39,7 +39,7 @@ uint8_t echo_on;
 
 // Hold the command in the buffer and spin loop until the chunks of JSON 
 // are done outputting. Each chunk should be less than 32 bytes since that 
-// is the AVR UART buffer size. The main spin loop continues running until 
+// is the AVR UART buffer size (UART0_TX0_SIZE). The main spin loop continues running until 
 // the uart is available for write (e.g. buffer is empty) and then the buffer is 
 // loaded with the next JSON chunk (a over full buffer will block execution)
 void initCommandBuffer(void) 
@@ -29,8 +29,11 @@ https://en.wikipedia.org/wiki/BSD_licenses#0-clause_license_(%22Zero_Clause_BSD%
 // 7 .. prevent sending bad data
 uint8_t mgr_twiErrorCode;
 
-// largest I2C transaction with manager so far is six bytes.
-#define MAX_CMD_SIZE 8
+// analog_generation from the last command 32 reply, it changes when a manager reference or calibration has changed
+uint8_t mgr_analog_generation = MGR_ANALOG_GEN_NONE;
+
+// largest I2C transaction with manager so far is an event pull (27 bytes).
+#define MAX_CMD_SIZE 28
 
 uint8_t txBuffer_[MAX_CMD_SIZE];
 uint8_t bytes_to_write_; // master wrties bytes to slave (you may want to zero the last byte txBuffer array)
@@ -42,6 +45,10 @@ uint8_t i2c_address_; // master address this slave
 #define ADDRESS_CMD {0x00,0x00}
 #define ADDRESS_CMD_SIZE 2
 
+// command 7 reads the multi-drop framing (bit 7 clear is read)
+#define MPCM_CMD {0x07,0x00}
+#define MPCM_CMD_SIZE 2
+
 // command 4 reads the shutdown detected status
 #define SHUTDOWN_DETECT_CMD {0x04,0xFF}
 #define SHUTDOWN_DETECT_CMD_SIZE 2
@@ -60,6 +67,20 @@ uint8_t i2c_address_; // master address this slave
 #define INT_CMD {0x15,0x00,0x00}
 #define INT_CMD_SIZE 3
 
+// command 32 sends a fourth byte (0xFF) that the manager replaces with analog_generation, an older manager echos the 0xFF
+#define ADC_CMD_SIZE 4
+
+// command 22 has the manager pack a subsystem snapshot, sent with the subsystem and read back with SNAPSHOT_DONE set
+#define SNAPSHOT_CMD 0x16
+#define SNAPSHOT_DONE 0x80
+
+// command 23 sets the event batch route (bit 7 set, an older manager echos it) or pulls events (bit 7 clear)
+#define EVENTS_CMD 0x17
+#define EVENTS_SET_ROUTE 0x80
+#define EVENTS_CMD_SIZE 2
+#define EVENTS_PULL_HEADER 3
+#define EVENTS_PACKED_SIZE 6
+
 // commands 5 
 // have the manger access a read/write array of int. 
 // shutdown_halt_curr_limit
@@ -216,6 +237,33 @@ char i2c_get_Rpu_address(void)
     }
 }
 
+// The manager has the multi-drop framing that the host and all nodes on the bus use. 
+// RPU_MPCM_ON means the UART should use 9 data bits and MPCM (see uart0_bsd.c), 
+// if the manager can not be read use RPU_MPCM_OFF.
+uint8_t i2c_get_Rpu_mpcm(void)
+{ 
+    uint8_t i2c_address = I2C_ADDR_OF_BUS_MGR;    
+    uint8_t txBuffer[MPCM_CMD_SIZE] = MPCM_CMD;
+    uint8_t length = MPCM_CMD_SIZE;
+    mgr_twiErrorCode = twi0_masterBlockingWrite(i2c_address, txBuffer, length, TWI0_PROTOCALL_REPEATEDSTART); 
+    if (mgr_twiErrorCode)
+    {
+        return RPU_MPCM_OFF; // failed
+    }
+
+    uint8_t rxBuffer[MPCM_CMD_SIZE];
+    uint8_t bytes_read = twi0_masterBlockingRead(i2c_address, rxBuffer, length, TWI0_PROTOCALL_STOP);
+    if ( bytes_read != length )
+    {
+        mgr_twiErrorCode = 5;
+        return RPU_MPCM_OFF;
+    }
+    else
+    {
+        return (rxBuffer[1] == RPU_MPCM_ON) ? RPU_MPCM_ON : RPU_MPCM_OFF;
+    }
+}
+
 // I2C command 32 takes a channel and returns adc[channel]
 // channels are ALT_I | ALT_V | PWR_I | PWR_V
 int i2c_get_adc_from_manager(uint8_t channel, TWI0_LOOP_STATE_t *loop_state)
@@ -407,7 +455,7 @@ unsigned long i2c_ul_rwoff_access_cmd(uint8_t command, uint8_t rw_offset, unsign
 }
 
 // management commands that take an int to update and return an int e.g. 
-// 32 .. takes a ADC_CH_MGR_enum and returns the 10 bit adc reading (ALT_I | ALT_V | PWR_I | PWR_V)
+// 32 .. takes a ADC_CH_MGR_enum and returns the 10 bit adc reading (ALT_I | ALT_V | PWR_I | PWR_V), also updates mgr_analog_generation
 int i2c_int_access_cmd(uint8_t command, int update_with, TWI0_LOOP_STATE_t *loop_state)
 {
     if ( (command != 32) ) 
@@ -427,12 +475,13 @@ int i2c_int_access_cmd(uint8_t command, int update_with, TWI0_LOOP_STATE_t *loop
     if (*loop_state == TWI0_LOOP_STATE_INIT)
     {
         i2c_address_ = I2C_ADDR_OF_BUS_MGR; //0x29
-        bytes_to_write_ = INT_CMD_SIZE;
+        bytes_to_write_ = ADC_CMD_SIZE;
         txBuffer_[0] = command; // replace the command byte
         txBuffer_[1] = (uint8_t)((update_with & 0xFF00)>>8);
         txBuffer_[2] = (uint8_t)(update_with & 0xFF);
-        txBuffer_[3] = 0;
-        bytes_to_read_ = INT_CMD_SIZE;
+        txBuffer_[3] = MGR_ANALOG_GEN_NONE;
+        txBuffer_[4] = 0;
+        bytes_to_read_ = ADC_CMD_SIZE;
         rxBuffer_[0] = 0;
         rxBuffer_[1] = 0;
         rxBuffer_[2] = 0;
@@ -449,11 +498,13 @@ int i2c_int_access_cmd(uint8_t command, int update_with, TWI0_LOOP_STATE_t *loop
             {
                 mgr_twiErrorCode = twi0_masterAsyncWrite_status(); //bytes_read>>5
                 value = 0; // int does not have NaN
+                mgr_analog_generation = MGR_ANALOG_GEN_NONE;
             }
             else
             {
                 value = ((int)(rxBuffer_[1]))<<8;
                 value +=  (int)rxBuffer_[2];
+                mgr_analog_generation = rxBuffer_[3];
             }
         }
     }
@@ -584,4 +635,172 @@ float i2c_float_access_cmd(uint8_t command, uint8_t select, float *update_with,
         }
     }
     return value;
-}
\ No newline at end of file
+}
+
+// big endian values from the I2C reply
+static uint16_t rx_u16(uint8_t index)
+{
+    return (((uint16_t)rxBuffer_[index])<<8) + (uint16_t)rxBuffer_[index+1];
+}
+
+static uint32_t rx_u32(uint8_t index)
+{
+    return (((uint32_t)rx_u16(index))<<16) + (uint32_t)rx_u16(index+2);
+}
+
+// I2C command 22 reads a subsystem snapshot in one transaction, returns 1 when rxBuffer_ has the snapshot
+static uint8_t i2c_snapshot_cmd(uint8_t subsystem, uint8_t size, TWI0_LOOP_STATE_t *loop_state)
+{
+    if (*loop_state == TWI0_LOOP_STATE_INIT)
+    {
+        i2c_address_ = I2C_ADDR_OF_BUS_MGR; //0x29
+        bytes_to_write_ = size;
+        bytes_to_read_ = size;
+        txBuffer_[0] = SNAPSHOT_CMD;
+        txBuffer_[1] = subsystem;
+        for (uint8_t i = 2; i < size; i++)
+        {
+            txBuffer_[i] = 0;
+        }
+        for (uint8_t i = 0; i < size; i++)
+        {
+            rxBuffer_[i] = 0;
+        }
+        *loop_state = TWI0_LOOP_STATE_ASYNC_WRT; // set write state
+        return 0;
+    }
+    uint8_t bytes_read = twi0_masterWriteRead(i2c_address_, txBuffer_, bytes_to_write_, rxBuffer_, bytes_to_read_, loop_state);
+    if( (*loop_state == TWI0_LOOP_STATE_DONE) )
+    {
+        // twi0_masterWriteRead error code is in bits 5..7
+        if(bytes_read & 0xE0)
+        {
+            mgr_twiErrorCode = twi0_masterAsyncWrite_status(); // bytes_read>>5
+            return 0;
+        }
+        if (rxBuffer_[1] != (subsystem | SNAPSHOT_DONE))
+        {
+            mgr_twiErrorCode = 6; // manager does not have the snapshot command
+            return 0;
+        }
+        return 1;
+    }
+    return 0;
+}
+
+// day-night limits and state in one transaction (in place of five), snapshot is updated when it returns 1
+uint8_t i2c_daynight_snapshot(MGR_DAYNIGHT_SNAPSHOT_t *snapshot, TWI0_LOOP_STATE_t *loop_state)
+{
+    if ( !i2c_snapshot_cmd(SNAPSHOT_DAYNIGHT, SNAPSHOT_DAYNIGHT_SIZE, loop_state) ) return 0;
+    snapshot->state = rxBuffer_[2];
+    snapshot->morning_threshold = (int) rx_u16(3);
+    snapshot->evening_threshold = (int) rx_u16(5);
+    snapshot->morning_debounce = rx_u32(7);
+    snapshot->evening_debounce = rx_u32(11);
+    snapshot->timer = rx_u32(15);
+    snapshot->adc_alt_v = (int) rx_u16(19);
+    return 1;
+}
+
+// host shutdown limits and state in one transaction (in place of six), snapshot is updated when it returns 1
+uint8_t i2c_shutdown_snapshot(MGR_SHUTDOWN_SNAPSHOT_t *snapshot, TWI0_LOOP_STATE_t *loop_state)
+{
+    if ( !i2c_snapshot_cmd(SNAPSHOT_SHUTDOWN, SNAPSHOT_SHUTDOWN_SIZE, loop_state) ) return 0;
+    snapshot->state = rxBuffer_[2];
+    snapshot->halt_curr = (int) rx_u16(3);
+    snapshot->adc_pwr_i = (int) rx_u16(5);
+    snapshot->ttl = rx_u32(7);
+    snapshot->delay = rx_u32(11);
+    snapshot->wearlevel = rx_u32(15);
+    snapshot->timer = rx_u32(19);
+    return 1;
+}
+
+// all four manager adc channels (ADC_CH_MGR_t order) in one transaction, snapshot is updated when it returns 1
+uint8_t i2c_analog_snapshot(MGR_ANALOG_SNAPSHOT_t *snapshot, TWI0_LOOP_STATE_t *loop_state)
+{
+    if ( !i2c_snapshot_cmd(SNAPSHOT_ANALOG, SNAPSHOT_ANALOG_SIZE, loop_state) ) return 0;
+    for (uint8_t i = 0; i < ADC_CH_MGR_MAX_NOT_A_CH; i++)
+    {
+        snapshot->adc[i] = (int) rx_u16(2 + (2*i));
+    }
+    snapshot->generation = rxBuffer_[10];
+    mgr_analog_generation = snapshot->generation;
+    return 1;
+}
+
+// have the manager send events in batches on route (e.g., CB_ROUTE_EVENTS), route 0 sends each event on its own route.
+// 23 .. cmd plus one byte
+//       byte 1 is the route with bit 7 set, the manager returns the last route (bit 7 clear)
+void i2c_event_batch_cmd(uint8_t route)
+{
+    uint8_t i2c_address = I2C_ADDR_OF_BUS_MGR;
+    uint8_t txBuffer[EVENTS_CMD_SIZE] = {EVENTS_CMD, 0x00};
+    txBuffer[1] = route | EVENTS_SET_ROUTE;
+    uint8_t length = EVENTS_CMD_SIZE;
+    mgr_twiErrorCode = twi0_masterBlockingWrite(i2c_address, txBuffer, length, TWI0_PROTOCALL_REPEATEDSTART); 
+    if (mgr_twiErrorCode)
+    {
+        return; // failed
+    }
+
+    // above writes data to slave, this reads data from slave
+    uint8_t rxBuffer[EVENTS_CMD_SIZE];
+    uint8_t bytes_read = twi0_masterBlockingRead(i2c_address, rxBuffer, length, TWI0_PROTOCALL_STOP);
+    if ( bytes_read != length )
+    {
+        mgr_twiErrorCode = 5;
+        return;
+    }
+    if (rxBuffer[1] & EVENTS_SET_ROUTE)
+    {
+        mgr_twiErrorCode = 6; // manager does not have the events command
+    }
+}
+
+// I2C command 23 pulls up to max_events (four at most) waiting events from the manager, 
+// returns the number of events copied into events (six bytes each: route, data, and age) once loop_state is DONE. 
+// waiting is set to the number of events the manager still has.
+uint8_t i2c_pull_events(uint8_t *events, uint8_t max_events, uint8_t *waiting, TWI0_LOOP_STATE_t *loop_state)
+{
+    if (*loop_state == TWI0_LOOP_STATE_INIT)
+    {
+        if (max_events > ((MAX_CMD_SIZE - EVENTS_PULL_HEADER) / EVENTS_PACKED_SIZE)) max_events = (MAX_CMD_SIZE - EVENTS_PULL_HEADER) / EVENTS_PACKED_SIZE;
+        i2c_address_ = I2C_ADDR_OF_BUS_MGR; //0x29
+        bytes_to_write_ = EVENTS_PULL_HEADER + (max_events * EVENTS_PACKED_SIZE);
+        bytes_to_read_ = bytes_to_write_;
+        txBuffer_[0] = EVENTS_CMD;
+        txBuffer_[1] = 0;
+        txBuffer_[2] = max_events;
+        for (uint8_t i = EVENTS_PULL_HEADER; i < bytes_to_write_; i++)
+        {
+            txBuffer_[i] = 0;
+        }
+        for (uint8_t i = 0; i < bytes_to_read_; i++)
+        {
+            rxBuffer_[i] = 0;
+        }
+        *loop_state = TWI0_LOOP_STATE_ASYNC_WRT; // set write state
+        return 0;
+    }
+    uint8_t bytes_read = twi0_masterWriteRead(i2c_address_, txBuffer_, bytes_to_write_, rxBuffer_, bytes_to_read_, loop_state);
+    if( (*loop_state == TWI0_LOOP_STATE_DONE) )
+    {
+        // twi0_masterWriteRead error code is in bits 5..7
+        if(bytes_read & 0xE0)
+        {
+            mgr_twiErrorCode = twi0_masterAsyncWrite_status(); // bytes_read>>5
+            *waiting = 0;
+            return 0;
+        }
+        uint8_t count = rxBuffer_[1];
+        if ( (EVENTS_PULL_HEADER + (count * EVENTS_PACKED_SIZE)) > bytes_to_read_ ) count = 0; // not a reply to the pull
+        for (uint8_t i = 0; i < (count * EVENTS_PACKED_SIZE); i++)
+        {
+            events[i] = rxBuffer_[EVENTS_PULL_HEADER + i];
+        }
+        *waiting = rxBuffer_[2];
+        return count;
+    }
+    return 0;
+}
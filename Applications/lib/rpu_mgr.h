@@ -14,10 +14,49 @@ typedef enum ADC_CH_MGR_enum {
 
 extern uint8_t mgr_twiErrorCode;
 
+// subsystem snapshots from manager I2C command 22 (see i2c_*_snapshot)
+#define SNAPSHOT_DAYNIGHT 0
+#define SNAPSHOT_DAYNIGHT_SIZE 21
+#define SNAPSHOT_SHUTDOWN 1
+#define SNAPSHOT_SHUTDOWN_SIZE 23
+#define SNAPSHOT_ANALOG 2
+#define SNAPSHOT_ANALOG_SIZE 11
+
+typedef struct {
+    uint8_t state; // manager daynight_state
+    int morning_threshold;
+    int evening_threshold;
+    unsigned long morning_debounce;
+    unsigned long evening_debounce;
+    unsigned long timer; // elapsed time in the daynight_state
+    int adc_alt_v;
+} MGR_DAYNIGHT_SNAPSHOT_t;
+
+typedef struct {
+    uint8_t state; // manager shutdown_state
+    int halt_curr;
+    int adc_pwr_i;
+    unsigned long ttl;
+    unsigned long delay;
+    unsigned long wearlevel;
+    unsigned long timer; // elapsed shutdown_kRuntime used by the state machine
+} MGR_SHUTDOWN_SNAPSHOT_t;
+
+typedef struct {
+    int adc[ADC_CH_MGR_MAX_NOT_A_CH];
+    uint8_t generation; // also placed in mgr_analog_generation
+} MGR_ANALOG_SNAPSHOT_t;
+
+// manager references (cmd 38, 39) and calibrations (cmd 33) can be kept while mgr_analog_generation is the same,
+// MGR_ANALOG_GEN_NONE means the manager did not give a generation (e.g., an older manager) so read them each time
+#define MGR_ANALOG_GEN_NONE 0xFF
+extern uint8_t mgr_analog_generation;
+
 extern void i2c_ping(void);
 extern uint8_t i2c_set_Rpu_shutdown(void);
 extern uint8_t i2c_detect_Rpu_shutdown(void);
 extern char i2c_get_Rpu_address(void);
+extern uint8_t i2c_get_Rpu_mpcm(void);
 extern int i2c_get_adc_from_manager(uint8_t channel, TWI0_LOOP_STATE_t *loop_state);
 extern uint8_t i2c_read_status(void);
 extern void i2c_daynight_cmd(uint8_t dn_callback_addr, uint8_t dn_callback_route, uint8_t d_callback_route, uint8_t n_callback_route);
@@ -27,6 +66,15 @@ extern unsigned long i2c_ul_rwoff_access_cmd(uint8_t command, uint8_t rw_offset,
 extern int i2c_int_access_cmd(uint8_t command, int update_with, TWI0_LOOP_STATE_t *loop_state);
 extern int i2c_int_rwoff_access_cmd(uint8_t command, uint8_t rw_offset, int update_with, TWI0_LOOP_STATE_t *loop_state);
 float i2c_float_access_cmd(uint8_t command, uint8_t select, float *update_with, TWI0_LOOP_STATE_t *loop_state);
+extern uint8_t i2c_daynight_snapshot(MGR_DAYNIGHT_SNAPSHOT_t *snapshot, TWI0_LOOP_STATE_t *loop_state);
+extern uint8_t i2c_shutdown_snapshot(MGR_SHUTDOWN_SNAPSHOT_t *snapshot, TWI0_LOOP_STATE_t *loop_state);
+extern uint8_t i2c_analog_snapshot(MGR_ANALOG_SNAPSHOT_t *snapshot, TWI0_LOOP_STATE_t *loop_state);
+extern void i2c_event_batch_cmd(uint8_t route);
+extern uint8_t i2c_pull_events(uint8_t *events, uint8_t max_events, uint8_t *waiting, TWI0_LOOP_STATE_t *loop_state);
+
+// values from i2c_get_Rpu_mpcm
+#define RPU_MPCM_OFF 0 /* 8 data bits, every node sees every command line */
+#define RPU_MPCM_ON 1 /* 9 data bits, the host sends the address as an address frame befor each command line */
 
 // values used for i2c_*_rwoff_access_cmd
 #define RW_READ_BIT 0x00
@@ -24,15 +24,18 @@ https://en.wikipedia.org/wiki/BSD_licenses#0-clause_license_(%22Zero_Clause_BSD%
 uint8_t i2c0Buffer[I2C_BUFFER_LENGTH];
 uint8_t i2c0BufferLength = 0;
 volatile uint8_t twi_slave_errorCode;
+uint32_t mgr_event_age;
+
+// table of pointers to functions that are selected by the i2c cmmand byte
+static void (*pf[GROUP][MGR_CMDS])(uint8_t*) = 
+{
+    {fnNull, fnDayNightState, fnDayWork, fnNightWork, fnBatMgrState, fnHostShutdownState, fnEvents, fnNull}
+};
 
 // called when I2C data is received. 
 void receive_i2c_event(uint8_t* inBytes, uint8_t numBytes) 
 {
-    // table of pointers to functions that are selected by the i2c cmmand byte
-    static void (*pf[GROUP][MGR_CMDS])(uint8_t*) = 
-    {
-        {fnNull, fnDayNightState, fnDayWork, fnNightWork, fnBatMgrState, fnHostShutdownState, fnNull, fnNull}
-    };
+    mgr_event_age = 0; // a single callback is sent when it happens
 
     // i2c will echo's back what was sent (plus modifications) with transmit event
     uint8_t i;
@@ -133,6 +136,35 @@ void fnHostShutdownState(uint8_t* i2cBuffer)
     twi0_onHostShutdownState(data); // run the registered callback (the default callback does nothing)
 }
 
+// run the route callbacks for events packed by the manager (route, data, and four byte age), 
+// used for a batch sent on CB_ROUTE_EVENTS and for events pulled with i2c_pull_events
+void mgr_events_dispatch(const uint8_t *events, uint8_t count)
+{
+    uint8_t event[2];
+    for (uint8_t i = 0; i < count; i++)
+    {
+        event[0] = events[0];
+        event[1] = events[1];
+        mgr_event_age = ((uint32_t)events[2])<<24;
+        mgr_event_age += ((uint32_t)events[3])<<16;
+        mgr_event_age += ((uint32_t)events[4])<<8;
+        mgr_event_age += (uint32_t)events[5];
+        if ( (event[0] > CB_ROUTE_NULL) && (event[0] < CB_ROUTE_EVENTS) )
+        {
+            (* pf[0][event[0]])(event);
+        }
+        events += MGR_EVENT_PACKED_SIZE;
+    }
+}
+
+// I2C command with a batch of events, byte[1] is the number of events that follow
+void fnEvents(uint8_t* i2cBuffer)
+{
+    uint8_t count = i2cBuffer[1];
+    if ( (2 + (count * MGR_EVENT_PACKED_SIZE)) > i2c0BufferLength ) return; // not all there
+    mgr_events_dispatch(&i2cBuffer[2], count);
+}
+
 /* Dummy function */
 void fnNull(uint8_t* i2cBuffer)
 {
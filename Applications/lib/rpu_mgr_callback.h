@@ -26,9 +26,16 @@ extern void fnNightWork(uint8_t*); // function that receives an i2c slave event
 extern void fnBatMgrState(uint8_t*); // function that receives an i2c slave event on the above route
 #define CB_ROUTE_HS_STATE  5 /* route to report host shutdown manager state */
 extern void fnHostShutdownState(uint8_t*); // function that receives an i2c slave event on the above route
-// not used // 6
+#define CB_ROUTE_EVENTS  6 /* route to receive a batch of the above events (see i2c_event_batch_cmd) */
+extern void fnEvents(uint8_t*); // function that runs the above callbacks for each event in the batch
 // not used // 7
 
+// events are packed as route, data, and the mSec (four bytes) the event waited in the manager
+#define MGR_EVENT_PACKED_SIZE 6
+#define MGR_EVENT_BATCH_MAX 4
+extern uint32_t mgr_event_age; // a callback can use this to see how long the event waited (zero for a single callback)
+extern void mgr_events_dispatch(const uint8_t *events, uint8_t count);
+
 /* Dummy function */
 extern  void fnNull(uint8_t*);
 
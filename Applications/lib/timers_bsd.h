@@ -3,9 +3,51 @@
 
 #define MICROSEC_TICK_CORRECTION (( (64 * 256) / ( F_CPU / 1000000UL ) ) % 1000UL)
 
+// ISRs that can wake the MCU from idle sleep (see idle_bsd.h), an ISR that is not stamped shows as WAKE_OTHER
+typedef enum WAKE_enum {
+    WAKE_TIMER0, // the tick
+    WAKE_UART0, // receive
+    WAKE_UART1,
+    WAKE_UART2,
+    WAKE_TWI0,
+    WAKE_TWI1,
+    WAKE_ADC,
+    WAKE_CAPTURE, // ICP1, ICP3, or ICP4
+    WAKE_OTHER,
+    WAKE_SOURCES
+} WAKE_t;
+
+extern volatile uint32_t tick;
+
+// set befor the MCU sleeps, the first ISR after it marks which it was and the Timer0 count it started at.
+// The count is the low byte of tick with TCNT0 (an overflow the tick ISR has not counted yet is added), like timer0CountsAtomic.
+// It is inline since a function call would make every ISR that stamps save more registers.
+extern volatile uint8_t wake_armed;
+extern volatile uint8_t wake_source;
+extern volatile uint16_t wake_counts;
+#define wake_stamp(source) do { if (wake_armed) { \
+    uint8_t wake_tcnt = TCNT0; \
+    uint8_t wake_tick = (uint8_t) tick; \
+    if ( (TIFR0 & (1<<TOV0)) && (wake_tcnt < 255) ) ++wake_tick; \
+    wake_counts = ((uint16_t) wake_tick << 8) | wake_tcnt; \
+    wake_source = (source); \
+    wake_armed = 0; } } while (0)
+
+// wake latency is the crystal counts from the interrupt to its ISR (at the stamp), only an input capture ISR can measure it 
+// (TCNTn - ICRn, its timer runs at clk/1). For the others the datasheet gives the bound for the first interrupt after 
+// idle sleep: four cycles of response, four more since it was asleep, and the three cycle jump in the vector table.
+#define WAKE_LATENCY_BOUND 11
+extern volatile uint16_t wake_latency;
+#define wake_stamp_latency(source, latency) do { if (wake_armed) { wake_latency = (latency); } wake_stamp(source); } while (0)
+
+// Timer0 counts (clk/64) to microseconds, an 8 bit count fits the 32 bit math
+#define WAKE_COUNTS_TO_USEC(counts) ((uint16_t) (((uint32_t) (counts) * 64000UL) / (F_CPU / 1000UL)))
+
 extern void initTimers(void);
 extern uint32_t tickAtomic(void);
+extern uint32_t timer0CountsAtomic(void);
 extern unsigned long milliseconds(void);
+extern unsigned long microseconds(void);
 unsigned long elapsed(unsigned long *);
 
 #endif // TimersTick_h
@@ -31,6 +31,7 @@ IO hardware, the master ISR can be on one set of hardware while the slave ISR is
 #include <util/twi.h>
 #include "io_enum_bsd.h"
 #include "twi0_bsd.h"
+#include "timers_bsd.h"
 
 static volatile uint8_t twi0_slave_read_write;
 
@@ -148,6 +149,7 @@ void twi0_acknowledge(TWI_ACK_t ack)
 
 ISR(TWI0_vect)
 {
+    wake_stamp(WAKE_TWI0);
     switch(TWSR0 & TW0_STATUS_MASK) // TW_STATUS and TW_STATUS_MASK can be used for parts with one TWI
     {
         // Illegal start or stop condition
@@ -29,12 +29,21 @@ sent before the linefeed, its put() routine must implement this
 
 UART0_TX_REPLACE_NL_WITH_CR and UART0_RX_REPLACE_CR_WITH_NL may be used 
 to filter data into and out of the uart.
+
+UART0_MPCM_ADDRESSING uses 9 data bits and the Multi-processor Communication Mode (MPCM).
+The host sends the node address with the ninth bit set (an address frame) and then the 
+command line with the ninth bit clear (data frames). The receiver hardware drops data frames 
+while MPCM is set, so a node that is not addressed does not take an interrupt for them. 
+When the address frame matches, MPCM is cleared until the end of the line (CR or NL).
+An address frame for another node means the host is starting an exchange with it, 
+uart0_addressedElsewhere() tells the main loop so it can stop sending (e.g., abort a reply).
 */
 
 #include <stdio.h>
 #include <stdbool.h>
 #include <util/atomic.h>
 #include "uart0_bsd.h"
+#include "timers_bsd.h"
 
 //  if 0x8000 bit is set then (U2X) Double speed mode is used
 #define UART0_BAUD_SELECT(baudRate) ((F_CPU+8UL*(baudRate))/(16UL*(baudRate))-1UL)
@@ -47,19 +56,47 @@ static volatile uint8_t RxHead;
 static volatile uint8_t RxTail;
 
 static uint8_t options;
+static uint8_t mpcm_address;
+static volatile uint8_t addressed_elsewhere;
 volatile uint8_t UART0_error;
 
 ISR(USART0_RX_vect)
 {
+    wake_stamp(WAKE_UART0);
     uint16_t next_index;
     uint8_t data;
  
     // check USARTn Control and Status Register A for Frame Error (FE) or Data OverRun (DOR)
     uint8_t last_status = (UCSR0A & ((1<<FE)|(1<<DOR)) );
 
+    // the ninth bit (RXB8) also needs to be read befor UDR0
+    uint8_t address_frame = (UCSR0B & (1<<RXB8));
+
     // above errors are valid until UDR0 is read, e.g., now
     data = UDR0;
 
+    if (options & UART0_MPCM_ADDRESSING)
+    {
+        if (address_frame)
+        {
+            if (data == mpcm_address)
+            {
+                UCSR0A &= ~(1<<MPCM); // take the command line that follows
+            }
+            else
+            {
+                UCSR0A |= (1<<MPCM); // another node was addressed
+                addressed_elsewhere = 1;
+            }
+            UART0_error = last_status;
+            return; // address frames are not put in the buffer
+        }
+        if ( (data == '\r') || (data == '\n') )
+        {
+            UCSR0A |= (1<<MPCM); // end of line, wait for the next address frame
+        }
+    }
+
     next_index = ( RxHead + 1) & ( UART0_RX0_SIZE - 1);
     
     if ( next_index == RxTail ) 
@@ -113,12 +150,70 @@ int uart0_available(void)
     return (UART0_RX0_SIZE + RxHead - RxTail) & ( UART0_RX0_SIZE - 1);
 }
 
+// An address frame for another node was received since the last call (MPCM addressing only), it is cleared when read.
+bool uart0_addressedElsewhere(void)
+{
+    bool elsewhere;
+    ATOMIC_BLOCK ( ATOMIC_RESTORESTATE )
+    {
+        elsewhere = addressed_elsewhere;
+        addressed_elsewhere = 0;
+    }
+    return elsewhere;
+}
+
 // Transmit buffer (all of it) is available for writing without blocking.
 bool uart0_availableForWrite(void)
 {
     return (TxHead == TxTail);
 }
 
+// Number of bytes that can be put in the transmit buffer without blocking (one slot is kept open).
+uint8_t uart0_writeSpace(void)
+{
+    return (UART0_TX0_SIZE - 1) - ((UART0_TX0_SIZE + TxHead - TxTail) & ( UART0_TX0_SIZE - 1));
+}
+
+// Put one byte in the transmit buffer if there is room, returns 1 if it was taken or 0 if the buffer is full.
+// The byte is sent as is (e.g., UART0_TX_REPLACE_NL_WITH_CR is not used), so binary data is safe.
+uint8_t uart0_try_write(uint8_t data)
+{
+    uint8_t next_index = (TxHead + 1) & ( UART0_TX0_SIZE - 1);
+    if (next_index == TxTail)
+    {
+        return 0;
+    }
+    TxBuf[next_index] = data;
+    TxHead = next_index;
+    UCSR0B |= (1<<UDRIE);
+    return 1;
+}
+
+// Put up to len bytes in the transmit buffer without blocking, returns the number taken.
+// The caller keeps the rest and tries again on a later loop.
+uint8_t uart0_write(const uint8_t *buf, uint8_t len)
+{
+    uint8_t next_index;
+    uint8_t head = TxHead;
+    uint8_t count = 0;
+    while (count < len)
+    {
+        next_index = (head + 1) & ( UART0_TX0_SIZE - 1);
+        if (next_index == TxTail)
+        {
+            break;
+        }
+        TxBuf[next_index] = buf[count++];
+        head = next_index;
+    }
+    if (count)
+    {
+        TxHead = head; // the ISR sees all the new bytes at once
+        UCSR0B |= (1<<UDRIE);
+    }
+    return count;
+}
+
 // Protofunctions (code is latter) to allow UART0 to be used as a stream for printf, scanf, etc...
 int uart0_putchar(char c, FILE *stream);
 int uart0_getchar(FILE *stream);
@@ -153,6 +248,15 @@ FILE *uart0_init(uint32_t baudrate, uint8_t choices)
         }
         UCSR0B = (1<<RXCIE)|(1<<RXEN)|(1<<TXEN); // enable TX and RX
         UCSR0C = (3<<UCSZ0); // control frame format asynchronous, 8data, no parity, 1stop bit
+        if (choices & UART0_MPCM_ADDRESSING)
+        {
+            UCSR0B |= (1<<UCSZ2); // 9data, transmit with TXB8 clear (data frames)
+            UCSR0A |= (1<<MPCM); // wait for an address frame
+        }
+        else
+        {
+            UCSR0A &= ~(1<<MPCM);
+        }
         UBRR0H = (uint8_t)(ubrr>>8);
         UBRR0L = (uint8_t) ubrr;
     }
@@ -162,6 +266,12 @@ FILE *uart0_init(uint32_t baudrate, uint8_t choices)
     return &uartstream0_f;
 }
 
+// Address that clears MPCM when it is received as an address frame (e.g., '1' is 0x31)
+void uart0_mpcm_address(uint8_t address)
+{
+    mpcm_address = address;
+}
+
 // putchar for sending to stdio stream
 int uart0_putchar(char c, FILE *stream)
 {
@@ -4,13 +4,25 @@
 // https://www.microchip.com/webdoc/AVRLibcReferenceManual/group__avr__stdio.html
 #include <stdio.h>
 
-// Buffer size: (1<<5), (1<<4), (1<<3), (1<<2).
+// Buffer size: (1<<8), (1<<7), (1<<6), (1<<5), (1<<4), (1<<3), (1<<2).
+// An application can select other sizes in its Makefile, e.g., CPPFLAGS += -DUART0_TX0_SIZE=128
+#ifndef UART0_RX0_SIZE
 #define UART0_RX0_SIZE (1<<5)
+#endif
+#ifndef UART0_TX0_SIZE
 #define UART0_TX0_SIZE (1<<5)
+#endif
+#if (UART0_RX0_SIZE > 256) || (UART0_RX0_SIZE & (UART0_RX0_SIZE - 1))
+#   error UART0_RX0_SIZE needs to be a power of two that is not more than 256
+#endif
+#if (UART0_TX0_SIZE > 256) || (UART0_TX0_SIZE & (UART0_TX0_SIZE - 1))
+#   error UART0_TX0_SIZE needs to be a power of two that is not more than 256
+#endif
 
 // options
 #define UART0_TX_REPLACE_NL_WITH_CR 0x01         // replace transmited newline with carriage return
 #define UART0_RX_REPLACE_CR_WITH_NL 0x02         // replace receive carriage return with newline
+#define UART0_MPCM_ADDRESSING       0x04         // 9 data bits, hardware drops data frames until an address frame matches
 
 // error codes
 #define UART0_NO_DATA               (1<<0)       // no receive data available bit 0
@@ -25,7 +37,12 @@ extern void uart0_flush(void);
 extern void uart0_empty(void);
 extern int uart0_available(void);
 extern bool uart0_availableForWrite(void);
+extern bool uart0_addressedElsewhere(void);
+extern uint8_t uart0_writeSpace(void);
+extern uint8_t uart0_try_write(uint8_t data);
+extern uint8_t uart0_write(const uint8_t *buf, uint8_t len);
 extern FILE *uart0_init(uint32_t baudrate, uint8_t choices);
+extern void uart0_mpcm_address(uint8_t address);
 extern int uart0_putchar(char c, FILE *stream);
 extern int uart0_getchar(FILE *stream);
 
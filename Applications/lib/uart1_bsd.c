@@ -0,0 +1,336 @@
+/*
+Interrupt-Driven UART for AVR Standard IO facilities streams 
+Copyright (C) 2020 Ronald Sutherland
+
+Permission to use, copy, modify, and/or distribute this software for any purpose with or without fee is hereby granted.
+
+THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES 
+WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF 
+MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE 
+FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY 
+DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, 
+WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, 
+ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+https://en.wikipedia.org/wiki/BSD_licenses#0-clause_license_(%22Zero_Clause_BSD%22)
+
+API is done in C for AVR Standard IO facilities streams
+https://www.microchip.com/webdoc/AVRLibcReferenceManual/group__avr__stdio.html
+
+The standard streams stdin, stdout, and stderr are provided, but contrary to the C standard, 
+since avr-libc has no knowledge about applicable devices, these streams are not already 
+pre-initialized at application startup. Also, since there is no notion of "file" whatsoever to 
+avr-libc, there is no function fopen() that could be used to associate a stream to some device. 
+Instead, the function fdevopen() is provided to associate a stream to a device, where the device 
+needs to provide a function to send a character, to receive a character, or both. There is no 
+differentiation between "text" and "binary" streams inside avr-libc. Character \n is sent literally 
+down to the device's put() function. If the device requires a carriage return (\r) character to be 
+sent before the linefeed, its put() routine must implement this 
+
+UART1_TX_REPLACE_NL_WITH_CR and UART1_RX_REPLACE_CR_WITH_NL may be used 
+to filter data into and out of the uart.
+*/
+
+#include <stdio.h>
+#include <stdbool.h>
+#include <util/atomic.h>
+#include "uart1_bsd.h"
+#include "timers_bsd.h"
+
+//  if 0x8000 bit is set then (U2X) Double speed mode is used
+#define UART1_BAUD_SELECT(baudRate) ((F_CPU+8UL*(baudRate))/(16UL*(baudRate))-1UL)
+
+static volatile uint8_t TxBuf[UART1_TX1_SIZE];
+static volatile uint8_t RxBuf[UART1_RX1_SIZE];
+static volatile uint8_t TxHead;
+static volatile uint8_t TxTail;
+static volatile uint8_t RxHead;
+static volatile uint8_t RxTail;
+
+static volatile uint64_t StampBuf[UART1_STAMP_SIZE];
+static volatile uint8_t StampHead;
+static volatile uint8_t StampTail;
+static volatile uint8_t StampLine[UART1_STAMP_SIZE]; // line number of each stamp
+static volatile uint8_t line_count; // lines started, the ISR counts them even if the stamp did not fit
+static uint8_t line_popped; // lines the main loop has asked for a stamp
+static uint8_t line_start = 1;
+static uint64_t (*line_stamp_time)(void);
+
+static uint8_t options;
+volatile uint8_t UART1_error;
+
+ISR(USART1_RX_vect)
+{
+    wake_stamp(WAKE_UART1);
+    uint16_t next_index;
+    uint8_t data;
+ 
+    // check USARTn Control and Status Register A for Frame Error (FE) or Data OverRun (DOR)
+    uint8_t last_status = (UCSR1A & ((1<<FE)|(1<<DOR)) );
+
+    // above errors are valid until UDR1 is read, e.g., now
+    data = UDR1;
+
+    next_index = ( RxHead + 1) & ( UART1_RX1_SIZE - 1);
+    
+    if ( next_index == RxTail ) 
+    {
+        last_status += UART1_BUFFER_OVERFLOW;
+    } 
+    else 
+    {
+        RxHead = next_index;
+        RxBuf[next_index] = data;
+
+        if ( (data == '\r') || (data == '\n') )
+        {
+            line_start = 1;
+        }
+        else if (line_start)
+        {
+            line_start = 0;
+            uint8_t line = line_count++;
+            if (line_stamp_time)
+            {
+                uint8_t next_stamp = (StampHead + 1) & (UART1_STAMP_SIZE - 1);
+                if (next_stamp == StampTail)
+                {
+                    last_status += UART1_STAMP_OVERFLOW; // the line number of the next stamp will show this one is missing
+                }
+                else
+                {
+                    StampBuf[next_stamp] = line_stamp_time();
+                    StampLine[next_stamp] = line;
+                    StampHead = next_stamp;
+                }
+            }
+        }
+    }
+    UART1_error = last_status;   
+}
+
+
+ISR(USART1_UDRE_vect)
+{
+    uint16_t tmptail;
+
+    if ( TxHead != TxTail) 
+    {
+        tmptail = (TxTail + 1) & ( UART1_TX1_SIZE - 1); // calculate and store new buffer index
+        TxTail = tmptail;
+        UDR1 = TxBuf[tmptail]; // get one byte from buffer and send it with UART
+    } 
+    else 
+    {
+        UCSR1B &= ~(1<<UDRIE); // tx buffer empty, disable UDRE interrupt
+    }
+}
+
+// Flush bytes from the transmit buffer with busy waiting.
+void uart1_flush(void)
+{
+    while (TxHead != TxTail)
+    {
+        //busy waiting
+    };
+}
+
+// Immediately stop transmitting by removing any buffered outgoing serial data.
+// helps to reduce/avoid collision damage on full-duplex multi-drop
+void uart1_empty(void)
+{
+    TxHead = TxTail;
+}
+
+// Number of bytes available in the receive buffer.
+int uart1_available(void)
+{
+    return (UART1_RX1_SIZE + RxHead - RxTail) & ( UART1_RX1_SIZE - 1);
+}
+
+// Transmit buffer (all of it) is available for writing without blocking.
+bool uart1_availableForWrite(void)
+{
+    return (TxHead == TxTail);
+}
+
+// Number of bytes that can be put in the transmit buffer without blocking (one slot is kept open).
+uint8_t uart1_writeSpace(void)
+{
+    return (UART1_TX1_SIZE - 1) - ((UART1_TX1_SIZE + TxHead - TxTail) & ( UART1_TX1_SIZE - 1));
+}
+
+// Put one byte in the transmit buffer if there is room, returns 1 if it was taken or 0 if the buffer is full.
+// The byte is sent as is (e.g., UART1_TX_REPLACE_NL_WITH_CR is not used), so binary data is safe.
+uint8_t uart1_try_write(uint8_t data)
+{
+    uint8_t next_index = (TxHead + 1) & ( UART1_TX1_SIZE - 1);
+    if (next_index == TxTail)
+    {
+        return 0;
+    }
+    TxBuf[next_index] = data;
+    TxHead = next_index;
+    UCSR1B |= (1<<UDRIE);
+    return 1;
+}
+
+// Put up to len bytes in the transmit buffer without blocking, returns the number taken.
+// The caller keeps the rest and tries again on a later loop.
+uint8_t uart1_write(const uint8_t *buf, uint8_t len)
+{
+    uint8_t next_index;
+    uint8_t head = TxHead;
+    uint8_t count = 0;
+    while (count < len)
+    {
+        next_index = (head + 1) & ( UART1_TX1_SIZE - 1);
+        if (next_index == TxTail)
+        {
+            break;
+        }
+        TxBuf[next_index] = buf[count++];
+        head = next_index;
+    }
+    if (count)
+    {
+        TxHead = head; // the ISR sees all the new bytes at once
+        UCSR1B |= (1<<UDRIE);
+    }
+    return count;
+}
+
+// Protofunctions (code is latter) to allow UART1 to be used as a stream for printf, scanf, etc...
+int uart1_putchar(char c, FILE *stream);
+int uart1_getchar(FILE *stream);
+
+// Stream declaration for stdio
+static FILE uartstream1_f = FDEV_SETUP_STREAM(uart1_putchar, uart1_getchar, _FDEV_SETUP_RW);
+
+// Initialize the UART and return file handle
+// disable UART if baudrate is zero
+// choices e.g., UART1_TX_REPLACE_NL_WITH_CR & UART1_RX_REPLACE_CR_WITH_NL
+FILE *uart1_init(uint32_t baudrate, uint8_t choices)
+{
+    uint16_t ubrr = UART1_BAUD_SELECT(baudrate);
+
+    TxHead = 0;
+    TxTail = 0;
+    RxHead = 0;
+    RxTail = 0;
+    StampHead = 0;
+    StampTail = 0;
+    line_count = 0;
+    line_popped = 0;
+    line_start = 1;
+
+    // disconnect UART if baudrate is zero (ubrr is 0/-1 in this case)
+    if (baudrate == 0)
+    {
+        uint8_t local_UCSR1B = UCSR1B & ~(1<<TXEN); // trun off the transmiter
+        UCSR1B = local_UCSR1B;
+    }
+    else
+    {
+        if (ubrr & 0x8000) 
+        {
+            UCSR1A = (1<<U2X);  //Double speed mode (bit in status register)
+            ubrr &= ~0x8000;
+        }
+        UCSR1B = (1<<RXCIE)|(1<<RXEN)|(1<<TXEN); // enable TX and RX
+        UCSR1C = (3<<UCSZ0); // control frame format asynchronous, 8data, no parity, 1stop bit
+        UBRR1H = (uint8_t)(ubrr>>8);
+        UBRR1L = (uint8_t) ubrr;
+    }
+
+    options = choices;
+
+    return &uartstream1_f;
+}
+
+// putchar for sending to stdio stream
+int uart1_putchar(char c, FILE *stream)
+{
+    uint16_t next_index;
+
+    next_index  = (TxHead + 1) & ( UART1_TX1_SIZE - 1);
+
+    while ( next_index == TxTail ) 
+    {
+        ;// busy wait for free space in buffer
+    }
+
+    // I put a carriage return and newline in the printf string  
+    // so I don't use UART1_TX_REPLACE_NL_WITH_CR
+    if ( (options & UART1_TX_REPLACE_NL_WITH_CR) && (c == '\n') )
+    {
+        TxBuf[next_index] = (uint8_t)'\r';
+    }
+    else
+    {
+        TxBuf[next_index] = (uint8_t) c;
+    }
+    TxHead = next_index;
+
+    // Data Register Empty Interrupt Enable (UDRIE)
+    // When the UDRIE bit in UCSRnB is written to '1', the USART Data Register Empty Interrupt 
+    // will be executed as long as UDRE is set (provided that global interrupts are enabled).
+    UCSR1B |= (1<<UDRIE);
+
+    return 0;
+}
+
+// getchar for reading from stdio stream
+int uart1_getchar(FILE *stream)
+{
+    uint16_t next_index;
+    uint8_t data;
+
+    while( !(uart1_available()) );  // wait for input
+
+    if ( RxHead == RxTail ) 
+    {
+        UART1_error += UART1_NO_DATA;
+        data = 0;
+    }
+    else
+    {
+        next_index = (RxTail + 1) & ( UART1_RX1_SIZE - 1);
+        RxTail = next_index;
+        data = RxBuf[next_index]; // get byte from rx buffer
+    }
+
+    // I use UART1_RX_REPLACE_CR_WITH_NL to simplify command parsing from a host 
+    if ( (options & UART1_RX_REPLACE_CR_WITH_NL) && (data == '\r') ) data = '\n';
+    return (int) data;
+}
+
+
+
+// register a function that returns the time base for line stamps, e.g., icpNow or NULL to stop
+void uart1_registerLineStamp( uint64_t (*function)(void) )
+{
+    ATOMIC_BLOCK ( ATOMIC_RESTORESTATE )
+    {
+        line_stamp_time = function;
+    }
+}
+
+// pop the stamp of the next line, returns false if there is none (e.g., it did not fit in the stamp buffer).
+// Call it once for each line that has something other than CR or NL in it, lines with a missing stamp are skipped by number.
+bool uart1_lineStamp(uint64_t *stamp)
+{
+    uint8_t line = line_popped++;
+    if (StampHead == StampTail)
+    {
+        return false;
+    }
+    uint8_t next_stamp = (StampTail + 1) & (UART1_STAMP_SIZE - 1);
+    if (StampLine[next_stamp] != line)
+    {
+        return false; // the stamp for this line was lost, the one in the buffer is for a later line
+    }
+    *stamp = StampBuf[next_stamp]; // the ISR will not write this slot until StampTail moves past it
+    StampTail = next_stamp;
+    return true;
+}
@@ -0,0 +1,56 @@
+#ifndef UART1_H
+#define UART1_H
+
+// https://www.microchip.com/webdoc/AVRLibcReferenceManual/group__avr__stdio.html
+#include <stdio.h>
+
+// Buffer size: (1<<8), (1<<7), (1<<6), (1<<5), (1<<4), (1<<3), (1<<2).
+// An application can select other sizes in its Makefile, e.g., CPPFLAGS += -DUART1_TX1_SIZE=128
+#ifndef UART1_RX1_SIZE
+#define UART1_RX1_SIZE (1<<5)
+#endif
+#ifndef UART1_TX1_SIZE
+#define UART1_TX1_SIZE (1<<5)
+#endif
+#if (UART1_RX1_SIZE > 256) || (UART1_RX1_SIZE & (UART1_RX1_SIZE - 1))
+#   error UART1_RX1_SIZE needs to be a power of two that is not more than 256
+#endif
+#if (UART1_TX1_SIZE > 256) || (UART1_TX1_SIZE & (UART1_TX1_SIZE - 1))
+#   error UART1_TX1_SIZE needs to be a power of two that is not more than 256
+#endif
+
+// options
+#define UART1_TX_REPLACE_NL_WITH_CR 0x01         // replace transmited newline with carriage return
+#define UART1_RX_REPLACE_CR_WITH_NL 0x02         // replace receive carriage return with newline
+
+// error codes
+#define UART1_NO_DATA               (1<<0)       // no receive data available bit 0
+#define UART1_BUFFER_OVERFLOW       (1<<1)       // receive ringbuffer overflow bit 1
+#define UART1_OVERRUN_ERROR         (1<<DOR)     // from USARTn Control and Status Register A bit 3 for Data OverRun (DOR)
+#define UART1_FRAME_ERROR           (1<<FE)      // from USARTn Control and Status Register A bit 4 for Frame Error (FE)
+#define UART1_STAMP_OVERFLOW        (1<<2)       // line stamp buffer overflow bit 2
+
+// error codes UART_FRAME_ERROR, UART_OVERRUN_ERROR, UART_BUFFER_OVERFLOW, UART_NO_DATA
+extern volatile uint8_t UART1_error;
+
+extern void uart1_flush(void);
+extern void uart1_empty(void);
+extern int uart1_available(void);
+extern bool uart1_availableForWrite(void);
+extern uint8_t uart1_writeSpace(void);
+extern uint8_t uart1_try_write(uint8_t data);
+extern uint8_t uart1_write(const uint8_t *buf, uint8_t len);
+extern FILE *uart1_init(uint32_t baudrate, uint8_t choices);
+extern int uart1_putchar(char c, FILE *stream);
+extern int uart1_getchar(FILE *stream);
+
+// Line stamps: with a time base registered the RX ISR saves the time of the first byte of each line
+// (a byte that is not CR or NL after a CR or NL), e.g., uart1_registerLineStamp(icpNow) to align with ICP3/ICP4 events.
+// The time is when the first byte finished (its stop bit), so the line started one character time before.
+// Pop one stamp for each line that has something other than CR or NL in it (even if it is not kept), they are in the 
+// same order as the lines. A line whose stamp did not fit in the buffer pops false and the lines after it stay in step.
+#define UART1_STAMP_SIZE (1<<2)
+extern void uart1_registerLineStamp( uint64_t (*function)(void) );
+extern bool uart1_lineStamp(uint64_t *stamp);
+
+#endif // UART1_H 
@@ -26,7 +26,9 @@ how to use the buffer
 
 #include <util/atomic.h>
 #include "adc_bsd.h"
+#include "timers_bsd.h"
 #include "io_enum_bsd.h"
+#include "sched_bsd.h"
 
 
 volatile int adc[ADC_CHANNELS];
@@ -34,18 +36,59 @@ volatile ADC_CH_t adc_channel;
 volatile uint8_t ADC_auto_conversion;
 volatile uint8_t analog_reference;
 volatile uint8_t adc_isr_status;
+volatile uint32_t adc_burst_tick;
+volatile uint8_t adc_burst_count;
+volatile uint16_t adc_decimated[ADC_CHANNELS];
+volatile uint8_t adc_oversample_bits;
+volatile uint8_t adc_alt_v_stale;
 
 static uint8_t free_running;
+static uint16_t oversample_sum;
+static uint8_t oversample_count;
+static uint8_t trigger_ticks; // zero unless enable_ADC_timer_trigger was used
+static uint32_t trigger_due_tick;
 
 // Interrupt service routine started with enable_ADC_auto_conversion
 ISR(ADC_vect){
+    wake_stamp(WAKE_ADC);
+    if ( trigger_ticks && (ADCSRA & (1<<ADATE)) )
+    {
+        // a Timer0 overflow started this conversion (ADATE is set on the tick befor one is due), only the one on the due tick starts a burst.
+        uint32_t now_tick = tickAtomic();
+        if ( ((int32_t)(now_tick - trigger_due_tick)) < 0 ) return;
+        trigger_due_tick += trigger_ticks;
+        if ( ((int32_t)(now_tick - trigger_due_tick)) >= 0 ) trigger_due_tick = now_tick + trigger_ticks; // fell behind
+        adc_burst_tick = now_tick;
+        adc_isr_status = ISR_ADCBURST_START;
+        ADCSRA &= ~(1<<ADATE); // the ISR starts the rest of the burst so an overflow can not start one on the wrong channel
+    }
     if( (adc_channel == ADC_CH_ALT_V) && (ioRead(MCU_IO_ALT_EN)) )
     {
         // do not save this adc reading, it may be wrong.
+        oversample_sum = 0;
+        oversample_count = 0;
+        adc_alt_v_stale = 1;
+    }
+    else if (adc_oversample_bits)
+    {
+        // 4**n conversions of the channel are added before moving on, 64*1023 fits in the uint16 sum
+        oversample_sum += ADC;
+        if ( ++oversample_count < (1<<(adc_oversample_bits<<1)) )
+        {
+            ADCSRA |= (1<<ADSC); // same channel again
+            return;
+        }
+        adc[adc_channel] = oversample_sum >> (adc_oversample_bits<<1); // average, still 10 bits
+        adc_decimated[adc_channel] = oversample_sum >> adc_oversample_bits; // 10 + n bits
+        oversample_sum = 0;
+        oversample_count = 0;
+        if (adc_channel == ADC_CH_ALT_V) adc_alt_v_stale = 0;
     }
     else
     {
         adc[adc_channel] = ADC;
+        adc_decimated[adc_channel] = adc[adc_channel];
+        if (adc_channel == ADC_CH_ALT_V) adc_alt_v_stale = 0;
     }
     
     ++adc_channel;
@@ -55,6 +98,7 @@ ISR(ADC_vect){
     case ADC_CH_ALT_V:
         if ( ioRead(MCU_IO_ALT_EN) ) // skip ADC_CH_ALT_V when alternat enable
         {
+            adc_alt_v_stale = 1;
             adc_channel = ADC_CH_PWR_I; 
         }
         break;
@@ -70,6 +114,8 @@ ISR(ADC_vect){
     default:
         adc_channel = 0;
         adc_isr_status = ISR_ADCBURST_DONE; // mark to notify burst is done
+        ++adc_burst_count;
+        sched_event(SCHED_EVENT_ADC);
         break;
     }
 
@@ -92,7 +138,9 @@ ISR(ADC_vect){
     {
         ADCSRA |= (1<<ADSC);
         adc_isr_status = ISR_ADCBURST_START;
+        adc_burst_tick = tickAtomic();
     }
+    // with trigger_ticks the main loop sets ADATE again on the tick befor the next burst is due (arm_ADC_timer_trigger)
 }
 
 
@@ -166,9 +214,26 @@ void init_ADC_single_conversion(uint8_t reference)
 // in a buffer.
 void enable_ADC_auto_conversion(uint8_t free_run)
 {
+#if defined(ADCSRA) && defined(ADMUX)
+    // a conversion in flight (e.g., a burst that is not done) is on another channel, let it finish and drop it
+    // so the ISR does not save it as channel 0, then select channel 0 for the first conversion.
+    ATOMIC_BLOCK ( ATOMIC_RESTORESTATE )
+    {
+        ADCSRA &= ~((1<<ADIE) | (1<<ADATE));
+    }
+    while (ADCSRA & (1<<ADSC));
+    ADCSRA |= (1<<ADIF); // writing a one clears the flag
+    ADMUX = (ADMUX & ~(ADREFSMASK) & ~(1<<ADLAR) & ~(1<<MUX3) & ~(1<<MUX2) & ~(1<<MUX1) & ~(1<<MUX0)) | analog_reference;
+#else
+#   error missing ADCSRA or ADMUX register
+#endif
     adc_channel = 0;
     adc_isr_status = ISR_ADCBURST_START; // mark so we know new readings are arriving
     free_running = free_run;
+    trigger_ticks = 0;
+    oversample_sum = 0;
+    oversample_count = 0;
+    adc_burst_tick = tickAtomic();
 
 #if defined(ADCSRA)
 	// Power up the ADC and set it for conversion with interrupts enabled
@@ -182,6 +247,88 @@ void enable_ADC_auto_conversion(uint8_t free_run)
     ADC_auto_conversion =1;
 }
 
+// Before setting the ADC Timer Trigger mode, use init_ADC_single_conversion 
+// to select reference and set the adc_clock pre-scaler. The Timer0 overflow (tick) is 
+// the auto trigger source, and a burst is started every ticks (1.024mSec at 16MHz, 1.365mSec at 12MHz), 
+// so the readings are evenly spaced no matter how long the main loop takes. The tick that started the last 
+// burst is from adcBurstTickAtomic, and adc_burst_count goes up by one when a burst is done. 
+// A burst has to be done before the next is due, e.g., eight channels take more than one tick.
+// Call arm_ADC_timer_trigger from the main loop, the auto trigger is only enabled on the tick befor a burst is due.
+void enable_ADC_timer_trigger(uint8_t ticks)
+{
+    if (!ticks) ticks = 1;
+    adc_channel = 0;
+    adc_isr_status = ISR_ADCBURST_DONE; // the first burst starts on the next overflow
+    free_running = 0;
+    trigger_ticks = ticks;
+    oversample_sum = 0;
+    oversample_count = 0;
+    trigger_due_tick = tickAtomic() + 1;
+
+#if defined(ADCSRB) && defined(ADTS2)
+    // ADTS[2:0] set 0b100 auto trigger source is Timer/Counter0 Overflow
+    ADCSRB = (ADCSRB & ~((1<<ADTS2) | (1<<ADTS1) | (1<<ADTS0))) | (1<<ADTS2);
+#else
+#   error missing ADCSRB register which is used to select the auto trigger source
+#endif
+
+#if defined(ADCSRA)
+	// Power up the ADC with interrupts enabled, arm_ADC_timer_trigger sets ADATE when a burst is near
+    ADCSRA = ( (ADCSRA | (1<<ADEN) ) & ~(1<<ADATE) ) | (1 << ADIE);
+#else
+#   error missing ADCSRA register which has ADATE bit that is used to enable auto trigger
+#endif
+    ADC_auto_conversion =1;
+}
+
+// call from the main loop (at least once a tick) when enable_ADC_timer_trigger is used. 
+// ADATE is set only when the next Timer0 overflow makes the tick a burst is due on, so the overflows 
+// in between do not start a conversion (and an ISR) that would be thrown away. If the loop is late 
+// the burst starts on a later overflow and the ISR picks the next due tick from that one.
+void arm_ADC_timer_trigger(void)
+{
+    if (!trigger_ticks) return;
+    ATOMIC_BLOCK ( ATOMIC_RESTORESTATE )
+    {
+        if ( (adc_isr_status == ISR_ADCBURST_DONE) && !(ADCSRA & (1<<ADATE)) )
+        {
+            if ( ((int32_t)(tickAtomic() + 1 - trigger_due_tick)) >= 0 )
+            {
+                ADCSRA |= (1<<ADATE);
+            }
+        }
+    }
+}
+
+// return the tick that started the last burst, use atomic since the ISR changes it. 
+// The resolution is a tick (1.365mSec at 12MHz). With enable_ADC_timer_trigger the burst was started by the 
+// Timer0 overflow that made that tick, so it began at (tick << 8) in timer0CountsAtomic counts (within an ADC clock), 
+// with enable_ADC_auto_conversion it is the tick the ISR saw when it started the burst.
+uint32_t adcBurstTickAtomic(void)
+{
+    uint32_t local;
+    ATOMIC_BLOCK ( ATOMIC_RESTORESTATE )
+    {
+        local = adc_burst_tick;
+    }
+    return local;
+}
+
+// oversample and decimate, each channel in a burst is converted 4**n times (n is 0..ADC_OVERSAMPLE_MAX) 
+// adc[] has the average (10 bits) and adc_decimated[] has the sum shifted down by n (10 + n bits). 
+// The burst takes 4**n times longer, e.g., with n = 2 four channels take 64 conversions. 
+// adc_burst_count is the sequence number for a burst of results.
+void adc_oversample(uint8_t n)
+{
+    if (n > ADC_OVERSAMPLE_MAX) n = ADC_OVERSAMPLE_MAX;
+    ATOMIC_BLOCK ( ATOMIC_RESTORESTATE )
+    {
+        adc_oversample_bits = n;
+        oversample_sum = 0;
+        oversample_count = 0;
+    }
+}
+
 // return two byes from the last ADC update, use atomic to make sure ISR does not change it durring read
 int adcAtomic(ADC_CH_t channel)
 {
@@ -195,4 +342,18 @@ int adcAtomic(ADC_CH_t channel)
     } 
     else return 0;
 
-}
\ No newline at end of file
+}
+
+// return the decimated (10 + adc_oversample_bits) reading from the last ADC update
+uint16_t adcDecimatedAtomic(ADC_CH_t channel)
+{
+    uint16_t x;
+    if (channel < ADC_CHANNELS) {
+        ATOMIC_BLOCK ( ATOMIC_RESTORESTATE )
+        {
+            x = adc_decimated[channel];
+        }
+        return x;
+    } 
+    else return 0;
+}
@@ -91,7 +91,24 @@ extern void init_ADC_single_conversion(uint8_t);
 #define FREE_RUNNING 1
 #define BURST_MODE 0
 extern void enable_ADC_auto_conversion(uint8_t);
+extern void enable_ADC_timer_trigger(uint8_t ticks);
+extern void arm_ADC_timer_trigger(void);
+
+// tick that started the last burst (read it with adcBurstTickAtomic), and a count of the bursts done (e.g., to see one was missed)
+extern volatile uint32_t adc_burst_tick;
+extern volatile uint8_t adc_burst_count;
+extern uint32_t adcBurstTickAtomic(void);
+
+// oversampled readings have 10 + adc_oversample_bits of resolution (see adc_oversample)
+#define ADC_OVERSAMPLE_MAX 3
+extern volatile uint16_t adc_decimated[];
+extern volatile uint8_t adc_oversample_bits;
+
+// ALT_V is not converted while ALT_EN is set, this is set when the last burst did not update adc[ADC_CH_ALT_V]
+extern volatile uint8_t adc_alt_v_stale;
+extern void adc_oversample(uint8_t n);
 
 extern int adcAtomic(ADC_CH_t);
+extern uint16_t adcDecimatedAtomic(ADC_CH_t);
 
 #endif // AdcISR_h
@@ -0,0 +1,116 @@
+/*
+AVR idle sleep, the main loop sleeps when nothing is pending and the ISR that wakes it is timed
+Copyright (C) 2020 Ronald Sutherland
+
+Permission to use, copy, modify, and/or distribute this software for any purpose with or without fee is hereby granted.
+
+THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES 
+WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF 
+MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE 
+FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY 
+DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, 
+WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, 
+ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+https://en.wikipedia.org/wiki/BSD_licenses#0-clause_license_(%22Zero_Clause_BSD%22)
+
+
+The MCU sleeps in SLEEP_MODE_IDLE, the CPU clock stops but the IO clock runs, so Timer0, the UARTs, TWI, ADC, 
+and input capture keep working and any of their interrupts wake it. The Timer0 tick wakes it at least once a tick 
+(1.024mSec at 16MHz, 1.365mSec at 12MHz). ADC noise reduction mode also stops the IO clock, that would stop Timer0 
+(and the ADC burst trigger), UART receive, and a TWI master, so it is not used.
+
+The ISR to loop time is from the start of the ISR that woke the MCU (see wake_stamp in timers_bsd.h) to the main loop 
+running again, which is the time that ISR (and any that follow it) took. It does not include the wakeup itself 
+(the clock is running in idle, an interrupt starts four cycles later than when awake). It is in Timer0 counts (clk/64) 
+and is held at 255 if it is longer.
+
+The wake latency is from the interrupt to its ISR in crystal counts. An input capture ISR measures it from the 
+capture time (see wake_stamp_latency in timers_bsd.h), for other sources it is the WAKE_LATENCY_BOUND from the datasheet.
+*/
+
+#include <avr/io.h>
+#include <avr/interrupt.h>
+#include <avr/sleep.h>
+#include <util/atomic.h>
+#include "idle_bsd.h"
+
+static uint8_t (*idle_pending[IDLE_PENDING_MAX])(void);
+static uint8_t idle_pending_count;
+
+static IDLE_WAKE_t idle_wakes[WAKE_SOURCES];
+
+// add a check that keeps the MCU awake while it returns non-zero (e.g., a ring buffer has data).
+// Returns zero if there are already IDLE_PENDING_MAX checks.
+uint8_t idle_registerPending( uint8_t (*function)(void) )
+{
+    if (idle_pending_count >= IDLE_PENDING_MAX) return 0;
+    idle_pending[idle_pending_count++] = function;
+    return 1;
+}
+
+// sleep until an interrupt unless a check finds something pending, returns 1 if it slept.
+// The checks run with interrupts off, so an ISR that adds data after a check is held until sei(), and
+// sei() lets one more instruction run befor an interrupt, so the sleep happens and that interrupt wakes it.
+uint8_t idle_sleep(void)
+{
+    set_sleep_mode(SLEEP_MODE_IDLE);
+    cli();
+    for (uint8_t i = 0; i < idle_pending_count; i++)
+    {
+        if (idle_pending[i]())
+        {
+            sei();
+            return 0;
+        }
+    }
+    wake_armed = 1;
+    sleep_enable();
+    sei();
+    sleep_cpu();
+    sleep_disable();
+
+    // the ISR that woke it has run
+    uint8_t source = WAKE_OTHER;
+    uint8_t counts = 0;
+    uint16_t latency = WAKE_LATENCY_BOUND;
+    ATOMIC_BLOCK ( ATOMIC_RESTORESTATE )
+    {
+        if (!wake_armed)
+        {
+            source = wake_source;
+            if (source == WAKE_CAPTURE) latency = wake_latency;
+            uint16_t isr_to_loop = (uint16_t) timer0CountsAtomic() - wake_counts;
+            counts = (isr_to_loop > 0xFF) ? 0xFF : (uint8_t) isr_to_loop;
+        }
+        wake_armed = 0; // an ISR that does not stamp woke it
+    }
+    IDLE_WAKE_t *w = &idle_wakes[source];
+    if (w->count < 0xFFFF) w->count++;
+    w->last = counts;
+    if (counts > w->max) w->max = counts;
+    if (source != WAKE_OTHER)
+    {
+        w->latency_last = latency;
+        if (latency > w->latency_max) w->latency_max = latency;
+    }
+    return 1;
+}
+
+// copy the wake count, ISR to loop time, and wake latency of a source, only the main loop changes them
+void idle_wake(WAKE_t source, IDLE_WAKE_t *copy)
+{
+    *copy = idle_wakes[source];
+}
+
+void idle_reset(void)
+{
+    for (uint8_t i = 0; i < WAKE_SOURCES; i++)
+    {
+        idle_wakes[i].count = 0;
+        idle_wakes[i].last = 0;
+        idle_wakes[i].max = 0;
+        idle_wakes[i].latency_last = 0;
+        idle_wakes[i].latency_max = 0;
+    }
+}
@@ -0,0 +1,23 @@
+#ifndef Idle_h
+#define Idle_h
+
+#include <stdint.h>
+#include "timers_bsd.h"
+
+// checks that keep the MCU awake, they are called with interrupts off so keep them short
+#define IDLE_PENDING_MAX 4
+
+typedef struct {
+    uint16_t count; // times this source woke the MCU
+    uint8_t last; // ISR to loop time, Timer0 counts from the ISR start to the main loop (255 if longer), see WAKE_COUNTS_TO_USEC
+    uint8_t max;
+    uint16_t latency_last; // wake latency, crystal counts from the interrupt to the ISR (WAKE_LATENCY_BOUND if the source can not measure it)
+    uint16_t latency_max;
+} IDLE_WAKE_t;
+
+extern uint8_t idle_registerPending( uint8_t (*)(void) );
+extern uint8_t idle_sleep(void);
+extern void idle_wake(WAKE_t source, IDLE_WAKE_t *copy);
+extern void idle_reset(void);
+
+#endif // Idle_h
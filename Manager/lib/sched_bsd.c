@@ -0,0 +1,112 @@
+/*
+AVR cooperative scheduler, tasks run when a period is due or an ISR has flagged an event
+Copyright (C) 2020 Ronald Sutherland
+
+Permission to use, copy, modify, and/or distribute this software for any purpose with or without fee is hereby granted.
+
+THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES 
+WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF 
+MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE 
+FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY 
+DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, 
+WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, 
+ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+https://en.wikipedia.org/wiki/BSD_licenses#0-clause_license_(%22Zero_Clause_BSD%22)
+
+
+Tasks run from the main loop in the order they were added, each runs to completion (cooperative). When a pass 
+finds nothing due the application can sleep until an interrupt (see idle_bsd.h), register sched_pending() so 
+an event flagged befor the sleep keeps it awake.
+*/
+
+#include <util/atomic.h>
+#include <avr/interrupt.h>
+#include "timers_bsd.h"
+#include "sched_bsd.h"
+
+volatile uint8_t sched_events;
+
+static SCHED_TASK_t sched_task[SCHED_TASKS_MAX];
+static uint8_t sched_count;
+
+static void (*sched_onTaskDone)(uint8_t);
+
+// add a task that runs every period mSec (0 for none) and when any of the event bits are flagged.
+// Returns the id (tasks are numbered in the order added), or SCHED_FULL.
+uint8_t sched_add(void (*task)(void), uint16_t period, uint8_t events)
+{
+    if (sched_count >= SCHED_TASKS_MAX) return SCHED_FULL;
+    SCHED_TASK_t *t = &sched_task[sched_count];
+    t->task = task;
+    t->period = period;
+    t->events = events;
+    t->overrun = 0;
+    t->due = (uint16_t) milliseconds() + period;
+    return sched_count++;
+}
+
+// called with the task id after each task runs (e.g., to time it)
+void sched_registerTaskDoneCallback( void (*function)(uint8_t) )
+{
+    sched_onTaskDone = function;
+}
+
+// times the task was two or more periods late, the runs it missed were dropped
+uint8_t sched_overrun(uint8_t id)
+{
+    if (id >= sched_count) return 0;
+    return sched_task[id].overrun;
+}
+
+// run the tasks that are due, returns the number that ran.
+// The next due time is a deadline (due += period) so the period does not drift with the time a pass takes.
+uint8_t sched_run(void)
+{
+    uint8_t events;
+    ATOMIC_BLOCK ( ATOMIC_RESTORESTATE )
+    {
+        events = sched_events;
+        sched_events = 0;
+    }
+    uint16_t now = (uint16_t) milliseconds();
+    uint8_t ran = 0;
+    for (uint8_t id = 0; id < sched_count; id++)
+    {
+        SCHED_TASK_t *t = &sched_task[id];
+        uint8_t due = (t->events & events);
+        if ( t->period && ((int16_t)(now - t->due) >= 0) )
+        {
+            // a pass that is late by less than a period runs the task again on the next pass to catch up, 
+            // milliseconds() steps by two on some ticks at 12MHz so a one mSec task is often a period behind.
+            t->due += t->period;
+            if ((int16_t)(now - t->due) >= (int16_t) t->period)
+            {
+                t->due = now + t->period;
+                if (t->overrun < 255) t->overrun++;
+            }
+            due = 1;
+        }
+        if (due)
+        {
+            t->task();
+            ran++;
+            if (sched_onTaskDone) sched_onTaskDone(id);
+        }
+    }
+    return ran;
+}
+
+// events flagged since sched_run took them, or a period task that came due after sched_run sampled the time, 
+// idle_sleep calls it with interrupts off
+uint8_t sched_pending(void)
+{
+    if (sched_events) return 1;
+    uint16_t now = (uint16_t) milliseconds();
+    for (uint8_t id = 0; id < sched_count; id++)
+    {
+        SCHED_TASK_t *t = &sched_task[id];
+        if ( t->period && ((int16_t)(now - t->due) >= 0) ) return 1;
+    }
+    return 0;
+}
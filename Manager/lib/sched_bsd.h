@@ -0,0 +1,35 @@
+#ifndef Sched_h
+#define Sched_h
+
+#include <stdint.h>
+
+// event bits an ISR sets in sched_events, bits 4..7 are for the application
+#define SCHED_EVENT_ADC 0x01 // adc_bsd: a burst is done
+#define SCHED_EVENT_UART0 0x02 // uart0_bsd: a byte was received
+#define SCHED_EVENT_TWI0 0x04 // application: TWI0 slave receive callback
+#define SCHED_EVENT_TWI1 0x08 // application: TWI1 slave receive callback
+#define SCHED_EVENT_USER 0x10
+
+#define SCHED_TASKS_MAX 20
+#define SCHED_FULL 0xFF
+
+typedef struct {
+    void (*task)(void);
+    uint16_t period; // mSec, zero if it only runs on events
+    uint16_t due; // low bits of milliseconds() when the period is up
+    uint8_t events; // sched_events bits that make it run
+    uint8_t overrun; // times it was two or more periods late
+} SCHED_TASK_t;
+
+extern volatile uint8_t sched_events;
+
+// set event bits from an ISR (interrupts are off), use an ATOMIC_BLOCK in the main loop
+#define sched_event(bits) (sched_events |= (bits))
+
+extern uint8_t sched_add(void (*task)(void), uint16_t period, uint8_t events);
+extern void sched_registerTaskDoneCallback( void (*)(uint8_t) );
+extern uint8_t sched_overrun(uint8_t id);
+extern uint8_t sched_run(void);
+extern uint8_t sched_pending(void);
+
+#endif // Sched_h
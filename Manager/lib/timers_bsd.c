@@ -23,6 +23,17 @@ volatile uint32_t tick = 0;
 static uint32_t millisec_tick_last_used = 0;
 static uint16_t uS_balance = 0;
 static unsigned long millisec = 0;
+static uint32_t microsec_counts_last_used = 0;
+static uint8_t microsec_crystal_balance = 0;
+static unsigned long microsec = 0;
+
+volatile uint8_t wake_armed;
+volatile uint8_t wake_source;
+volatile uint16_t wake_counts;
+volatile uint16_t wake_latency;
+
+// crystal counts in a microsecond
+#define CRYSTAL_COUNTS_PER_MICROSEC (F_CPU / 1000000UL)
 
 ISR(TIMER0_OVF_vect)
 {
@@ -30,6 +41,9 @@ ISR(TIMER0_OVF_vect)
     uint32_t local_tick = tick;
     ++local_tick;
     tick = local_tick;
+
+    // after the count, since TOV0 was cleared when this ISR started
+    wake_stamp(WAKE_TIMER0);
 }
 
 /* setup Timer0: /64 Fast PWM
@@ -141,6 +155,22 @@ uint32_t tickAtomic()
     return local;
 }
 
+// returns the Timer0 count with the tick in the upper bits, e.g., (tick << 8) + TCNT0.
+// each count is 64 crystal counts (5.333uSec at 12MHz), used to time short things
+uint32_t timer0CountsAtomic(void)
+{
+    uint32_t local_tick;
+    uint8_t local_tcnt;
+    ATOMIC_BLOCK ( ATOMIC_RESTORESTATE )
+    {
+        local_tick = tick;
+        local_tcnt = TCNT0;
+        // an overflow that the ISR has not counted yet
+        if ( (TIFR0 & (1<<TOV0)) && (local_tcnt < 255) ) ++local_tick;
+    }
+    return (local_tick << 8) + local_tcnt;
+}
+
 // return the elapsed milliseconds given a pointer to a past time
 unsigned long elapsed(unsigned long *past)
 {
@@ -148,8 +178,9 @@ unsigned long elapsed(unsigned long *past)
     return now - *past;
 }
 
-// calculate milliseconds based on the TIMER0_OVF tick  
-// call every 250 ticks or the time will not be correct
+// calculate milliseconds based on the TIMER0_OVF tick, each tick is a millisecond plus MICROSEC_TICK_CORRECTION uSec 
+// that add up to a leap millisecond when uS_balance goes over 1000. The ticks since the last call are converted at once 
+// so a call after a long blocking section costs the same as any other.
 unsigned long milliseconds(void)
 {
     uint32_t now_tick;
@@ -160,34 +191,50 @@ unsigned long milliseconds(void)
 
     // differance between now and last tick used
     uint32_t ktick = now_tick - millisec_tick_last_used;
-    uint8_t ktick_byt;
-    if (ktick > 250) //limit looping delays
-    {
-         ktick_byt = 250;
-    }
-    else ktick_byt = (uint8_t) ktick;
-    if (ktick_byt)
+    if (ktick)
     {
-        while( ktick_byt ) 
+        // uS_balance + ktick * MICROSEC_TICK_CORRECTION would overflow, so each thousand ticks is done as a whole
+        uint32_t leap = (ktick / 1000UL) * MICROSEC_TICK_CORRECTION;
+        uint32_t balance = uS_balance + (ktick % 1000UL) * MICROSEC_TICK_CORRECTION;
+        if ( (balance == 0) && leap ) 
+        {
+            // a balance of 1000 is kept until the next tick
+            --leap;
+            balance = 1000;
+        }
+        if (balance)
         {
-            // update millisec time
-            ++millisec;
-            ktick_byt--; 
-            uS_balance  = uS_balance + MICROSEC_TICK_CORRECTION; // tick is a perfect unit of time in microseconds
-            if (uS_balance > 1000) 
-            {
-                uS_balance = uS_balance - 1000;
-                ++millisec; // add leap millisecond because tick is a perfect unit of time in microseconds which added up.
-            }
+            uint32_t extra = (balance - 1) / 1000UL;
+            leap += extra;
+            balance -= extra * 1000UL;
         }
+        uS_balance = (uint16_t) balance;
+        millisec += ktick + leap;
         millisec_tick_last_used = now_tick;
     }
     return millisec;
 }
 
+// calculate microseconds based on the Timer0 count (tick and TCNT0), each count is 64 crystal counts (5.333uSec at 12MHz).
+// The return value rolls over after 2**32 uSec (71.6 min), so use it for short times. 
+// Call it at least every 2**32 Timer0 counts (the tick rolls past 24 bits) or the time will not be correct.
+unsigned long microseconds(void)
+{
+    uint32_t now_counts = timer0CountsAtomic();
+    uint32_t kcounts = now_counts - microsec_counts_last_used;
+    microsec_counts_last_used = now_counts;
+
+    // kcounts * 64 would overflow, so do the whole microseconds first and keep the crystal counts left over
+    uint32_t crystal = (kcounts % CRYSTAL_COUNTS_PER_MICROSEC) * 64UL + microsec_crystal_balance;
+    microsec += (kcounts / CRYSTAL_COUNTS_PER_MICROSEC) * 64UL + (crystal / CRYSTAL_COUNTS_PER_MICROSEC);
+    microsec_crystal_balance = (uint8_t) (crystal % CRYSTAL_COUNTS_PER_MICROSEC);
+    return microsec;
+}
+
 
 // after 2**32 counts of the tick value it will role over, e.g. 2**(14+32) crystal counts. 
 // (2**(14+32))/16000000/3600/24 = 50.9 days
+// milliseconds() works from the difference with the last tick used, so it keeps counting over the rollover.
 
 // Note a capture is 16 bits, and extending it has proven to be a problem. 
 // it may be possible to merge the capture value and tick value to form a 46 bit event time. 
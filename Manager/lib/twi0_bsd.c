@@ -31,6 +31,7 @@ IO hardware, the master ISR can be on one set of hardware while the slave ISR is
 #include <util/twi.h>
 #include "io_enum_bsd.h"
 #include "twi0_bsd.h"
+#include "timers_bsd.h"
 
 static volatile uint8_t twi0_slave_read_write;
 
@@ -102,6 +103,9 @@ static volatile uint8_t twi0_masterBufferLength;
 static uint8_t twi0_slaveTxBuffer[TWI0_BUFFER_LENGTH];
 static volatile uint8_t twi0_slaveTxBufferIndex;
 static volatile uint8_t twi0_slaveTxBufferLength;
+static volatile uint8_t twi0_slaveTxDeferred; // callback has asked to hold SCL low until twi0_slaveTxRelease
+static volatile uint8_t twi0_slaveRxDeferred; // the next SLA+W is held (SCL low) until twi0_slaveRxRelease
+static volatile uint8_t twi0_slaveRxHeld; // SCL is low on a SLA+W waiting for twi0_slaveRxRelease
 
 // enable interleaving buffer for R-Pi Zero in header
 static uint8_t twi0_slaveRxBufferA[TWI0_BUFFER_LENGTH];
@@ -146,8 +150,23 @@ void twi0_acknowledge(TWI_ACK_t ack)
     }
 }
 
+// slave transmitter sends the next byte, ACK is expected if more bytes follow
+static void twi0_slaveTxByte(void)
+{
+    TWDR0 = twi0_slaveTxBuffer[twi0_slaveTxBufferIndex++];
+    if(twi0_slaveTxBufferIndex < twi0_slaveTxBufferLength)
+    {
+        twi0_acknowledge(TWI_ACK);
+    }
+    else
+    {
+        twi0_acknowledge(TWI_NACK);
+    }
+}
+
 ISR(TWI0_vect)
 {
+    wake_stamp(WAKE_TWI0);
     switch(TWSR0 & TW_STATUS_MASK) // TW_STATUS can be used for part with one TWI
     {
         // Illegal start or stop condition
@@ -247,6 +266,13 @@ ISR(TWI0_vect)
         case TW_SR_ARB_LOST_GCALL_ACK:
             twi0_MastSlav_RxTx_state = TWI_STATE_SLAVE_RECEIVER;
             twi0_slaveRxBufferIndex = 0;
+            if (twi0_slaveRxDeferred)
+            {
+                // the last write has not been taken, so TWINT is left set and SCL is held low until twi0_slaveRxRelease
+                twi0_slaveRxHeld = 1;
+                TWCR0 = (1<<TWEN) | (1<<TWEA);
+                break;
+            }
             twi0_acknowledge(TWI_ACK);
             break;
 
@@ -297,22 +323,20 @@ ISR(TWI0_vect)
             twi0_MastSlav_RxTx_state = TWI_STATE_SLAVE_TRANSMITTER;
             twi0_slaveTxBufferIndex = 0;
             twi0_slaveTxBufferLength = 0; 
-            twi0_onSlaveTx(); // use twi0_fillSlaveTxBuffer(bytes, length) in callback
+            twi0_onSlaveTx(); // use twi0_fillSlaveTxBuffer(bytes, length) or twi0_slaveTxDefer() in callback
+            if (twi0_slaveTxDeferred)
+            {
+                // TWINT is left set so SCL is held low (clock stretching), and the ISR is off until twi0_slaveTxRelease
+                TWCR0 = (1<<TWEN) | (1<<TWEA);
+                break;
+            }
             if(0 == twi0_slaveTxBufferLength) // default callback does not set this
             {
                 twi0_slaveTxBufferLength = 1;
                 twi0_slaveTxBuffer[0] = 0x00;
             }
         case TW_ST_DATA_ACK:
-            TWDR0 = twi0_slaveTxBuffer[twi0_slaveTxBufferIndex++];
-            if(twi0_slaveTxBufferIndex < twi0_slaveTxBufferLength)
-            {
-                twi0_acknowledge(TWI_ACK);
-            }
-            else
-            {
-                twi0_acknowledge(TWI_NACK);
-            }
+            twi0_slaveTxByte();
             break;
 
         // Slave data transmitted, ACK or NACK received
@@ -797,6 +821,60 @@ uint8_t twi0_fillSlaveTxBuffer(const uint8_t* slave_data, uint8_t bytes_to_send)
     return 0;
 }
 
+// use in the slave transmit callback when the reply is not ready, 
+// SCL is held low after the callback returns until twi0_slaveTxRelease is used
+void twi0_slaveTxDefer(void)
+{
+    twi0_slaveTxDeferred = 1;
+}
+
+// is SCL held low waiting for twi0_slaveTxRelease
+uint8_t twi0_slaveTxIsDeferred(void)
+{
+    return twi0_slaveTxDeferred;
+}
+
+// send the deferred reply after twi0_fillSlaveTxBuffer and release SCL, returns
+// 0: OK
+// 1: a reply was not deferred, so request ignored
+uint8_t twi0_slaveTxRelease(void)
+{
+    if (!twi0_slaveTxDeferred)
+    {
+        return 1;
+    }
+    twi0_slaveTxDeferred = 0;
+    if(0 == twi0_slaveTxBufferLength)
+    {
+        twi0_slaveTxBufferLength = 1;
+        twi0_slaveTxBuffer[0] = 0x00;
+    }
+    twi0_slaveTxByte(); // clears TWINT and turns the ISR back on
+    return 0;
+}
+
+// use in the slave receive callback when the bytes can not be taken yet, 
+// a following SLA+W is held with SCL low until twi0_slaveRxRelease is used
+void twi0_slaveRxDefer(void)
+{
+    twi0_slaveRxDeferred = 1;
+}
+
+// let the next SLA+W in, returns
+// 0: no write was waiting
+// 1: a write was held (SCL low) and is now released
+uint8_t twi0_slaveRxRelease(void)
+{
+    twi0_slaveRxDeferred = 0;
+    if (!twi0_slaveRxHeld)
+    {
+        return 0;
+    }
+    twi0_slaveRxHeld = 0;
+    twi0_acknowledge(TWI_ACK); // clears TWINT and turns the ISR back on
+    return 1;
+}
+
 // record callback to use durring a slave read operation 
 // a NULL pointer will use the default callback
 void twi0_registerSlaveRxCallback( void (*function)(uint8_t*, uint8_t) )
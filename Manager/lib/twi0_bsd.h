@@ -81,6 +81,11 @@ uint8_t twi0_masterWriteRead(uint8_t slave_address, uint8_t* write_data, uint8_t
 
 uint8_t twi0_slaveAddress(uint8_t slave);
 uint8_t twi0_fillSlaveTxBuffer(const uint8_t* slave_data, uint8_t bytes_to_send);
+void twi0_slaveTxDefer(void);
+uint8_t twi0_slaveTxIsDeferred(void);
+uint8_t twi0_slaveTxRelease(void);
+void twi0_slaveRxDefer(void);
+uint8_t twi0_slaveRxRelease(void);
 void twi0_registerSlaveRxCallback( void (*function)(uint8_t*, uint8_t) );
 void twi0_registerSlaveTxCallback( void (*function)(void) );
 
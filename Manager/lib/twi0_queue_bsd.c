@@ -0,0 +1,111 @@
+/*
+AVR TWI0 master queue, state machines post messages and one pump sends them
+Copyright (C) 2020 Ronald Sutherland
+
+Permission to use, copy, modify, and/or distribute this software for any purpose with or without fee is hereby granted.
+
+THE SOFTWARE IS PROVIDED "AS IS" AND THE AUTHOR DISCLAIMS ALL WARRANTIES 
+WITH REGARD TO THIS SOFTWARE INCLUDING ALL IMPLIED WARRANTIES OF 
+MERCHANTABILITY AND FITNESS. IN NO EVENT SHALL THE AUTHOR BE LIABLE 
+FOR ANY SPECIAL, DIRECT, INDIRECT, OR CONSEQUENTIAL DAMAGES OR ANY 
+DAMAGES WHATSOEVER RESULTING FROM LOSS OF USE, DATA OR PROFITS, 
+WHETHER IN AN ACTION OF CONTRACT, NEGLIGENCE OR OTHER TORTIOUS ACTION, 
+ARISING OUT OF OR IN CONNECTION WITH THE USE OR PERFORMANCE OF THIS SOFTWARE.
+
+https://en.wikipedia.org/wiki/BSD_licenses#0-clause_license_(%22Zero_Clause_BSD%22)
+
+Posting and pumping are both done from the main loop, the queue is not for use in an ISR.
+*/
+
+#include <stdint.h>
+#include "twi0_queue_bsd.h"
+
+static TWI0_QUEUE_MSG_t twi0_queue[TWI0_QUEUE_SIZE];
+static uint8_t twi0_queue_head; // next message to send
+static uint8_t twi0_queue_count;
+static uint8_t twi0_queue_max;
+static uint8_t twi0_queue_dropped;
+static uint8_t twi0_queue_last_error;
+static uint8_t twi0_queue_last_status;
+
+static TWI0_LOOP_STATE_t twi0_queue_loop_state = TWI0_LOOP_STATE_DONE;
+static uint8_t twi0_queue_rx[TWI0_QUEUE_MSG_SIZE];
+
+// add a message to the queue, returns
+// 1: queued
+// 0: dropped (queue full or message to long)
+uint8_t twi0_queue_post(uint8_t slave_address, const uint8_t *data, uint8_t length)
+{
+    if ( (twi0_queue_count >= TWI0_QUEUE_SIZE) || (length > TWI0_QUEUE_MSG_SIZE) )
+    {
+        if (twi0_queue_dropped < 255) twi0_queue_dropped++;
+        return 0;
+    }
+    uint8_t tail = twi0_queue_head + twi0_queue_count;
+    if (tail >= TWI0_QUEUE_SIZE) tail -= TWI0_QUEUE_SIZE;
+    twi0_queue[tail].address = slave_address;
+    twi0_queue[tail].length = length;
+    for (uint8_t i = 0; i < length; i++)
+    {
+        twi0_queue[tail].data[i] = data[i];
+    }
+    twi0_queue_count++;
+    if (twi0_queue_count > twi0_queue_max) twi0_queue_max = twi0_queue_count;
+    return 1;
+}
+
+// drive twi0_masterWriteRead for the message at the head of the queue, use in the main loop.
+// returns the number of messages waiting (including the one being sent)
+uint8_t twi0_queue_pump(void)
+{
+    if (!twi0_queue_count) return 0;
+
+    TWI0_QUEUE_MSG_t *msg = &twi0_queue[twi0_queue_head];
+    if (twi0_queue_loop_state == TWI0_LOOP_STATE_DONE)
+    {
+        twi0_queue_loop_state = TWI0_LOOP_STATE_ASYNC_WRT; // start the write
+    }
+    uint8_t bytes_read = twi0_masterWriteRead(msg->address, msg->data, msg->length, twi0_queue_rx, msg->length, &twi0_queue_loop_state);
+    if (twi0_queue_loop_state == TWI0_LOOP_STATE_DONE)
+    {
+        // twi0_masterWriteRead error code is in bits 5..7
+        twi0_queue_last_status = bytes_read>>5;
+        if (twi0_queue_last_status)
+        {
+            twi0_queue_last_error = twi0_queue_last_status;
+        }
+        if (++twi0_queue_head >= TWI0_QUEUE_SIZE) twi0_queue_head = 0;
+        twi0_queue_count--;
+    }
+    return twi0_queue_count;
+}
+
+// messages waiting
+uint8_t twi0_queue_depth(void)
+{
+    return twi0_queue_count;
+}
+
+// most messages that have waited at once
+uint8_t twi0_queue_high_water(void)
+{
+    return twi0_queue_max;
+}
+
+// messages dropped since the queue was full (stops at 255)
+uint8_t twi0_queue_drops(void)
+{
+    return twi0_queue_dropped;
+}
+
+// last twi0_masterWriteRead error (0 if none has happened)
+uint8_t twi0_queue_error(void)
+{
+    return twi0_queue_last_error;
+}
+
+// error of the last message sent (0 if it was sent)
+uint8_t twi0_queue_status(void)
+{
+    return twi0_queue_last_status;
+}
@@ -0,0 +1,24 @@
+#ifndef twi0_queue_h
+#define twi0_queue_h
+
+#include "twi0_bsd.h"
+
+// messages that wait for the TWI0 master, a post to a full queue is dropped (and counted)
+#define TWI0_QUEUE_SIZE 4
+#define TWI0_QUEUE_MSG_SIZE 26
+
+typedef struct {
+    uint8_t address; // slave address
+    uint8_t length; // bytes to write, the same number are read back
+    uint8_t data[TWI0_QUEUE_MSG_SIZE];
+} TWI0_QUEUE_MSG_t;
+
+uint8_t twi0_queue_post(uint8_t slave_address, const uint8_t *data, uint8_t length);
+uint8_t twi0_queue_pump(void);
+uint8_t twi0_queue_depth(void);
+uint8_t twi0_queue_high_water(void);
+uint8_t twi0_queue_drops(void);
+uint8_t twi0_queue_error(void);
+uint8_t twi0_queue_status(void);
+
+#endif // twi0_queue_h
@@ -31,6 +31,7 @@ IO hardware, the master ISR can be on one set of hardware while the slave ISR is
 #include <util/twi.h>
 #include "io_enum_bsd.h"
 #include "twi1_bsd.h"
+#include "timers_bsd.h"
 
 static volatile uint8_t twi1_slave_read_write;
 
@@ -148,6 +149,7 @@ void twi1_acknowledge(TWI_ACK_t ack)
 
 ISR(TWI1_vect)
 {
+    wake_stamp(WAKE_TWI1);
     switch(TWSR1 & TW_STATUS_MASK) // TW_STATUS can be used for part with one TWI
     {
         // Illegal start or stop condition
@@ -37,6 +37,8 @@ Register names (RXCIE0) and bits (FE0, DOR0, RXEN0, TXEN0, UCSZ00, UDRIE0) are f
 #include <stdbool.h>
 #include <util/atomic.h>
 #include "uart0_bsd.h"
+#include "timers_bsd.h"
+#include "sched_bsd.h"
 
 //  if 0x8000 bit is set then (U2X) Double speed mode is used
 #define UART0_BAUD_SELECT(baudRate) ((F_CPU+8UL*(baudRate))/(16UL*(baudRate))-1UL)
@@ -53,6 +55,7 @@ volatile uint8_t UART0_error;
 
 ISR(USART0_RX_vect)
 {
+    wake_stamp(WAKE_UART0);
     uint16_t next_index;
     uint8_t data;
  
@@ -74,6 +77,7 @@ ISR(USART0_RX_vect)
         RxBuf[next_index] = data;
     }
     UART0_error = last_status;   
+    sched_event(SCHED_EVENT_UART0);
 }
 
 
@@ -36,51 +36,105 @@ SOFTWARE.
 #include "../lib/io_enum_bsd.h"
 #include "../lib/adc_bsd.h"
 #include "adc_burst.h"
+#include "energy_counters.h"
 
-unsigned long adc_started_at;
 unsigned long accumulate_alt_ti;
 unsigned long accumulate_alt_mega_ti; // add to maga at 10E6 counts 
 unsigned long accumulate_pwr_ti;
 unsigned long accumulate_pwr_mega_ti;
 uint8_t add_half_LSB_every_other_accumulation; // because the ADC max value represents the selected reference voltage minus one LSB.
+static uint8_t alt_ti_fraction; // bits below the 10 bit LSB from the oversampled reading
+static uint8_t pwr_ti_fraction;
+ADC_STATS_t adc_stats[ADC_ENUM_END];
+uint16_t adc_stats_count;
 
-// every 10 mSec accumulate current (for Amp Hr) and scan the ADC channels
+// add the last burst to the stats window
+static void adc_stats_update(void)
+{
+    if (adc_stats_count == 0xFFFF)
+    {
+        for (uint8_t adc_enum = 0; adc_enum < ADC_ENUM_END; adc_enum++)
+        {
+            adc_stats[adc_enum].sum = adc_stats[adc_enum].sum >> 1;
+        }
+        adc_stats_count = adc_stats_count >> 1;
+    }
+    for (uint8_t adc_enum = 0; adc_enum < ADC_ENUM_END; adc_enum++)
+    {
+        uint16_t reading = adcDecimatedAtomic(adcMap[adc_enum].channel);
+        ADC_STATS_t *stats = &adc_stats[adc_enum];
+        if ( (adc_stats_count == 0) || (reading < stats->min) ) stats->min = reading;
+        if ( (adc_stats_count == 0) || (reading > stats->max) ) stats->max = reading;
+        stats->sum += reading;
+    }
+    adc_stats_count++;
+}
+
+// start a new stats window
+void adc_stats_reset(void)
+{
+    adc_stats_count = 0;
+    for (uint8_t adc_enum = 0; adc_enum < ADC_ENUM_END; adc_enum++)
+    {
+        adc_stats[adc_enum].min = 0;
+        adc_stats[adc_enum].max = 0;
+        adc_stats[adc_enum].sum = 0;
+    }
+}
+
+// every 10 mSec (the scheduler runs it each ADC_DELAY_MILSEC) accumulate current (for Amp Hr) and scan the ADC channels
 // high side curr sense for pwr_i is from 0.068 ohm, the adc reads 512 with 0.735 Amp
 // sampling data for an hour should give 735mAHr
 // ref_extern_avcc = 5.0; accumulate_pwr_ti = 512*(100 smp per Sec) * 3600 ( Sec per Hr)
 // accumulate_pwr_ti*((ref_extern_avcc)/1024.0)/(0.068*50.0)/360 is in mAHr 
 void adc_burst(void)
 {
-    unsigned long kRuntime= elapsed(&adc_started_at);
-    if ((kRuntime) > ((unsigned long)ADC_DELAY_MILSEC))
+    // a burst that is not done would be cut short by the restart, wait for the next period
+    if (adc_isr_status != ISR_ADCBURST_DONE) return;
+    if (add_half_LSB_every_other_accumulation)
+    {
+        accumulate_alt_ti += 1;
+        accumulate_pwr_ti += 1;
+        add_half_LSB_every_other_accumulation = 0;
+    }
+    else
+    {
+        add_half_LSB_every_other_accumulation = 1;
+    }
+    
+    ATOMIC_BLOCK ( ATOMIC_RESTORESTATE )
     {
-        if (add_half_LSB_every_other_accumulation)
+        // the decimated reading keeps its bits below the 10 bit LSB until they add up to one
+        uint8_t bits = adc_oversample_bits;
+        uint16_t mask = (1<<bits) - 1;
+        uint16_t reading = adc_decimated[MCU_IO_ALT_I];
+        accumulate_alt_ti += reading >> bits;
+        alt_ti_fraction += reading & mask;
+        if (alt_ti_fraction > mask)
         {
+            alt_ti_fraction -= (1<<bits);
             accumulate_alt_ti += 1;
-            accumulate_pwr_ti += 1;
-            add_half_LSB_every_other_accumulation = 0;
         }
-        else
+        if (accumulate_alt_ti > 1000000UL)
+        {
+            accumulate_alt_ti = accumulate_alt_ti - 1000000UL;
+            accumulate_alt_mega_ti += 1;
+        }
+        reading = adc_decimated[MCU_IO_PWR_I];
+        accumulate_pwr_ti += reading >> bits;
+        pwr_ti_fraction += reading & mask;
+        if (pwr_ti_fraction > mask)
         {
-            add_half_LSB_every_other_accumulation = 1;
+            pwr_ti_fraction -= (1<<bits);
+            accumulate_pwr_ti += 1;
         }
-        
-        ATOMIC_BLOCK ( ATOMIC_RESTORESTATE )
+        if (accumulate_pwr_ti > 1000000UL)
         {
-            accumulate_alt_ti += adc[MCU_IO_ALT_I];
-            if (accumulate_alt_ti > 1000000UL)
-            {
-                accumulate_alt_ti = accumulate_alt_ti - 1000000UL;
-                accumulate_alt_mega_ti += 1;
-            }
-            accumulate_pwr_ti += adc[MCU_IO_PWR_I];
-            if (accumulate_pwr_ti > 1000000UL)
-            {
-                accumulate_pwr_ti = accumulate_pwr_ti - 1000000UL;
-                accumulate_pwr_mega_ti += 1;
-            }
+            accumulate_pwr_ti = accumulate_pwr_ti - 1000000UL;
+            accumulate_pwr_mega_ti += 1;
         }
-        enable_ADC_auto_conversion(BURST_MODE);
-        adc_started_at += ADC_DELAY_MILSEC; 
-    } 
+    }
+    adc_stats_update();
+    energy_update();
+    enable_ADC_auto_conversion(BURST_MODE);
 }
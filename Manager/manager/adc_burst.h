@@ -8,10 +8,27 @@
 // so that amp hour values are good, and the math to convert the readings would be easy.
 #define ADC_DELAY_MILSEC 10UL
 
+// each channel is oversampled 4**1 times in a burst, the adc clock is 12MHz/128 (93.75kHz) and a conversion is 13 adc clocks 
+// plus the ISR, so 4 channels take about 16*(139+10) uSec or 2.4 mSec. With 4**2 it would be 64 conversions, about 9.5 mSec, 
+// which does not fit in the 10 mSec period once the tick jitter of the start is added.
+// adc[] is the average and adc_decimated[] has 11 bits
+#define ADC_OVERSAMPLE_BITS 1
+
+
+// min, max, and sum of the decimated readings since the stats were reset (cmd 34), in ADC_ENUM_t order.
+// sum and count are halved when count is full, so the mean keeps up with recent bursts
+typedef struct {
+    uint16_t min;
+    uint16_t max;
+    uint32_t sum;
+} ADC_STATS_t;
 
 extern void adc_burst(void);
+extern void adc_stats_reset(void);
+
+extern ADC_STATS_t adc_stats[];
+extern uint16_t adc_stats_count;
 
-extern unsigned long adc_started_at;
 extern unsigned long accumulate_alt_ti;
 extern unsigned long accumulate_alt_mega_ti;
 extern unsigned long accumulate_pwr_ti;
@@ -35,10 +35,10 @@ SOFTWARE.
 #include <ctype.h>
 #include <avr/pgmspace.h>
 #include <util/atomic.h>
-#include <avr/eeprom.h>
 #include "../lib/adc_bsd.h"
 #include "../lib/io_enum_bsd.h"
 #include "battery_limits.h"
+#include "param_store.h"
 
 BAT_LIM_t bat_limit_loaded;
 int battery_high_limit;
@@ -117,54 +117,36 @@ uint8_t IsValidBatHostLimFor24V(int *value)
     }
 }
 
-// wrtite battery high limit (when charging and PWM turns off) to EEPROM
+// stage battery high limit (when charging and PWM turns off) for the EEPROM journal
 uint8_t WriteEEBatHighLim() 
 {
-    if ( eeprom_is_ready() )
-    {
-        eeprom_update_word( (uint16_t *)(EE_BAT_LIMIT_ADDR+EE_BAT_LIMIT_OFFSET_HIGH), (uint16_t)battery_high_limit);
-        return 1;
-    }
-    else
-    {
-        return 0;
-    }
+    param.bat_high_limit = (uint16_t)battery_high_limit;
+    param_stage(PARAM_BAT_HIGH);
+    return 1;
 }
 
-// wrtite battery low limit (when PWM turns on) to EEPROM
+// stage battery low limit (when PWM turns on) for the EEPROM journal
 uint8_t WriteEEBatLowLim() 
 {
-    if ( eeprom_is_ready() )
-    {
-        eeprom_update_word( (uint16_t *)(EE_BAT_LIMIT_ADDR+EE_BAT_LIMIT_OFFSET_LOW), (uint16_t)battery_low_limit);
-        return 1;
-    }
-    else
-    {
-        return 0;
-    }
+    param.bat_low_limit = (uint16_t)battery_low_limit;
+    param_stage(PARAM_BAT_LOW);
+    return 1;
 }
 
-// wrtite battery host limit (when host turns off) to EEPROM
+// stage battery host limit (when host turns off) for the EEPROM journal
 uint8_t WriteEEBatHostLim() 
 {
-    if ( eeprom_is_ready() )
-    {
-        eeprom_update_word( (uint16_t *)(EE_BAT_LIMIT_ADDR+EE_BAT_LIMIT_OFFSET_HOST), (uint16_t)battery_host_limit);
-        return 1;
-    }
-    else
-    {
-        return 0;
-    }
+    param.bat_host_limit = (uint16_t)battery_host_limit;
+    param_stage(PARAM_BAT_HOST);
+    return 1;
 }
 
-// load Battery Limits from EEPROM (or set defaults)
+// load Battery Limits from the EEPROM shadow (or set defaults)
 uint8_t LoadBatLimitsFromEEPROM() 
 {
-    int tmp_battery_high_limit = eeprom_read_word((uint16_t*)(EE_BAT_LIMIT_ADDR+EE_BAT_LIMIT_OFFSET_HIGH));
-    int tmp_battery_low_limit = eeprom_read_word((uint16_t*)(EE_BAT_LIMIT_ADDR+EE_BAT_LIMIT_OFFSET_LOW));
-    int tmp_battery_host_limit = eeprom_read_word((uint16_t*)(EE_BAT_LIMIT_ADDR+EE_BAT_LIMIT_OFFSET_HOST));
+    int tmp_battery_high_limit = param.bat_high_limit;
+    int tmp_battery_low_limit = param.bat_low_limit;
+    int tmp_battery_host_limit = param.bat_host_limit;
     uint8_t use_defauts = 0;
     if ( !(IsValidBatHighLimFor12V(&tmp_battery_high_limit) || IsValidBatHighLimFor24V(&tmp_battery_high_limit)) ) use_defauts = 1;
     if ( !(IsValidBatLowLimFor12V(&tmp_battery_low_limit) || IsValidBatLowLimFor24V(&tmp_battery_low_limit)) ) use_defauts = 1;
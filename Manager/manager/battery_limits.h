@@ -1,7 +1,7 @@
 #ifndef Battery_limits_H
 #define Battery_limits_H
 
-//References EEPROM memory usage. 
+//EEPROM memory usage befor the journal (see param_store.h), it is copied once. 
 #define EE_BAT_LIMIT_ADDR 150
 // each setting is at this byte offset
 #define EE_BAT_LIMIT_OFFSET_HIGH 0
@@ -56,7 +56,6 @@ uint8_t bm_callback_address;
 uint8_t bm_callback_route;
 uint8_t bm_callback_poke;
 uint8_t bm_enable;
-TWI0_LOOP_STATE_t loop_state;
 unsigned long ontime;
 unsigned long next_ontime;
 
@@ -65,12 +64,6 @@ unsigned long next_ontime;
 // to do: pwm with a 2 second period, pwm ratio is from battery_high_limit at 25% to battery_low_limit at 75%
 void check_battery_manager(void)
 {
-    // TWI waiting to finish (ignore daynight changes while TWI is waiting)
-    if (i2c_callback_waiting(&loop_state)) return; 
-    
-    // if somthing else is using twi then my loop_state should allow getting to this, but I want to skip this state machine
-    if (i2c_is_in_use) return;
-
     // if battery limits are changing skip this state machine
     if (bat_limit_loaded > BAT_LIM_DEFAULT) return;
 
@@ -95,8 +88,7 @@ void check_battery_manager(void)
             bm_state = BATTERYMGR_STATE_START;
             if (bm_callback_address && bm_callback_route)
             {
-                if (loop_state == TWI0_LOOP_STATE_RAW) loop_state = TWI0_LOOP_STATE_INIT;
-                i2c_callback(bm_callback_address, bm_callback_route, bm_state + bm_enable, &loop_state); // update application
+                i2c_callback(bm_callback_address, bm_callback_route, bm_state + bm_enable); // update application
             }
         }
         return;
@@ -107,8 +99,7 @@ void check_battery_manager(void)
     {
         if (bm_callback_address && bm_callback_route)
         {
-            if (loop_state == TWI0_LOOP_STATE_RAW) loop_state = TWI0_LOOP_STATE_INIT;
-            i2c_callback(bm_callback_address, bm_callback_route, bm_state + bm_enable, &loop_state); // update application
+            i2c_callback(bm_callback_address, bm_callback_route, bm_state + bm_enable); // update application
         }
         bm_callback_poke = 0;
         if (bm_state >= BATTERYMGR_STATE_PREFAIL) bm_state = BATTERYMGR_STATE_START; // restart if bm failed
@@ -129,8 +120,7 @@ void check_battery_manager(void)
             bm_state = BATTERYMGR_STATE_PWM_MODE_OFF;
             if (bm_callback_address && bm_callback_route)
             {
-                if (loop_state == TWI0_LOOP_STATE_RAW) loop_state = TWI0_LOOP_STATE_INIT;
-                i2c_callback(bm_callback_address, bm_callback_route, bm_state + bm_enable, &loop_state); // update application
+                i2c_callback(bm_callback_address, bm_callback_route, bm_state + bm_enable); // update application
             }
             break;
 
@@ -142,8 +132,7 @@ void check_battery_manager(void)
                 bm_state = BATTERYMGR_STATE_CC_MODE;
                 if (bm_callback_address && bm_callback_route)
                 {
-                    if (loop_state == TWI0_LOOP_STATE_RAW) loop_state = TWI0_LOOP_STATE_INIT;
-                    i2c_callback(bm_callback_address, bm_callback_route, bm_state + bm_enable, &loop_state); // update application
+                    i2c_callback(bm_callback_address, bm_callback_route, bm_state + bm_enable); // update application
                 }
             }
             break;
@@ -160,8 +149,7 @@ void check_battery_manager(void)
                 bm_state = BATTERYMGR_STATE_PWM_MODE_OFF;
                 if (bm_callback_address && bm_callback_route)
                 {
-                    if (loop_state == TWI0_LOOP_STATE_RAW) loop_state = TWI0_LOOP_STATE_INIT;
-                    i2c_callback(bm_callback_address, bm_callback_route, bm_state + bm_enable, &loop_state); // update application
+                    i2c_callback(bm_callback_address, bm_callback_route, bm_state + bm_enable); // update application
                 }
                 break;
             }
@@ -174,8 +162,7 @@ void check_battery_manager(void)
                 alt_pwm_started_at += ALT_REST_PERIOD;
                 if (bm_callback_address && bm_callback_route)
                 {
-                    if (loop_state == TWI0_LOOP_STATE_RAW) loop_state = TWI0_LOOP_STATE_INIT;
-                    i2c_callback(bm_callback_address, bm_callback_route, bm_state + bm_enable, &loop_state); // update application
+                    i2c_callback(bm_callback_address, bm_callback_route, bm_state + bm_enable); // update application
                 }
             }
             break;
@@ -194,8 +181,7 @@ void check_battery_manager(void)
                 bm_state = BATTERYMGR_STATE_DONE; // charge is done
                 if (bm_callback_address && bm_callback_route)
                 {
-                    if (loop_state == TWI0_LOOP_STATE_RAW) loop_state = TWI0_LOOP_STATE_INIT;
-                    i2c_callback(bm_callback_address, bm_callback_route, bm_state + bm_enable, &loop_state); // update application
+                    i2c_callback(bm_callback_address, bm_callback_route, bm_state + bm_enable); // update application
                 }
                 break;
             }
@@ -211,8 +197,7 @@ void check_battery_manager(void)
 
                     if (bm_callback_address && bm_callback_route)
                     {
-                        if (loop_state == TWI0_LOOP_STATE_RAW) loop_state = TWI0_LOOP_STATE_INIT;
-                        i2c_callback(bm_callback_address, bm_callback_route, bm_state + bm_enable, &loop_state); // update application
+                        i2c_callback(bm_callback_address, bm_callback_route, bm_state + bm_enable); // update application
                     }
                 }
             }
@@ -249,8 +234,7 @@ void check_battery_manager(void)
                     bm_state = BATTERYMGR_STATE_PWM_MODE_OFF;
                     if (bm_callback_address && bm_callback_route)
                     {
-                        if (loop_state == TWI0_LOOP_STATE_RAW) loop_state = TWI0_LOOP_STATE_INIT;
-                        i2c_callback(bm_callback_address, bm_callback_route, bm_state + bm_enable, &loop_state); // update application
+                        i2c_callback(bm_callback_address, bm_callback_route, bm_state + bm_enable); // update application
                     }
                 }
                 else
@@ -258,8 +242,7 @@ void check_battery_manager(void)
                     bm_state = BATTERYMGR_STATE_CC_REST;
                     if (bm_callback_address && bm_callback_route)
                     {
-                        if (loop_state == TWI0_LOOP_STATE_RAW) loop_state = TWI0_LOOP_STATE_INIT;
-                        i2c_callback(bm_callback_address, bm_callback_route, bm_state + bm_enable, &loop_state); // update application
+                        i2c_callback(bm_callback_address, bm_callback_route, bm_state + bm_enable); // update application
                     }
                 }
             }
@@ -274,8 +257,7 @@ void check_battery_manager(void)
                 bm_state = BATTERYMGR_STATE_CC_REST;
                 if (bm_callback_address && bm_callback_route)
                 {
-                    if (loop_state == TWI0_LOOP_STATE_RAW) loop_state = TWI0_LOOP_STATE_INIT;
-                    i2c_callback(bm_callback_address, bm_callback_route, bm_state + bm_enable, &loop_state); // update application
+                    i2c_callback(bm_callback_address, bm_callback_route, bm_state + bm_enable); // update application
                 }
             }
             break;
@@ -285,8 +267,7 @@ void check_battery_manager(void)
             bm_state = BATTERYMGR_STATE_FAIL;
             if (bm_callback_address && bm_callback_route)
             {
-                if (loop_state == TWI0_LOOP_STATE_RAW) loop_state = TWI0_LOOP_STATE_INIT;
-                i2c_callback(bm_callback_address, bm_callback_route, bm_state + bm_enable, &loop_state); // update application
+                i2c_callback(bm_callback_address, bm_callback_route, bm_state + bm_enable); // update application
             }
             break;
 
@@ -306,8 +287,7 @@ void check_battery_manager(void)
             bm_state = BATTERYMGR_STATE_START;
             if (bm_callback_address && bm_callback_route)
             {
-                if (loop_state == TWI0_LOOP_STATE_RAW) loop_state = TWI0_LOOP_STATE_INIT;
-                i2c_callback(bm_callback_address, bm_callback_route, bm_state + bm_enable, &loop_state); // update application
+                i2c_callback(bm_callback_address, bm_callback_route, bm_state + bm_enable); // update application
             }
         }
         return;
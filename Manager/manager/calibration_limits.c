@@ -36,8 +36,9 @@ SOFTWARE.
 #include <string.h>
 #include <avr/pgmspace.h>
 #include <util/atomic.h>
-#include <avr/eeprom.h> 
 #include "calibration_limits.h"
+#include "references.h"
+#include "param_store.h"
 
 volatile uint8_t cal_loaded;
 volatile uint8_t adc_enum_with_writebit;
@@ -77,17 +78,16 @@ uint8_t IsValidValForCalChannel(void)
     return 0;
 }
 
-// save channel calibration if writebit is set and eeprom is ready
+// stage channel calibration for the EEPROM journal if writebit is set (param_store_commit does the burning)
 uint8_t WriteCalToEE(void)
 {
     if (adc_enum_with_writebit & 0x80)
     {
         uint8_t adc_enum  = adc_enum_with_writebit & 0x7F; // mask the writebit 
-        // use update functions to skip the burning if the old value is the same with new.
-        // https://www.microchip.com/webdoc/AVRLibcReferenceManual/group__avr__eeprom.html
-        if ( eeprom_is_ready() )
+        if (adc_enum < ADC_ENUM_END)
         {
-            eeprom_update_float( (float *)(EE_CAL_BASE_ADDR+(EE_CAL_OFFSET*adc_enum)), calMap[adc_enum].calibration);
+            param.calibration[adc_enum] = calMap[adc_enum].calibration;
+            param_stage( (PARAM_ID_t) (PARAM_CAL + adc_enum) );
             adc_enum_with_writebit = adc_enum;
             return 1;
         }
@@ -95,7 +95,7 @@ uint8_t WriteCalToEE(void)
     return 0;
 }
 
-// load a channel calibraion from EEPROM or set default if not valid (0 or 0xFFFFFFFF are not valid for calibration).
+// load a channel calibraion from the EEPROM shadow (param_store_load) or set default if not valid (0 or 0xFFFFFFFF are not valid for calibration).
 // Befor loading calibraions from EEPROM set 
 // cal_loaded = CAL_CLEAR; 
 // then loop load calibraion for each enum in ADC_ENUM_t
@@ -103,7 +103,7 @@ void LoadCalFromEEPROM(ADC_ENUM_t cal_map)
 {
     if (cal_map < ADC_ENUM_END) // ignore out of range
     {
-        calMap[cal_map].calibration = eeprom_read_float((float *)(EE_CAL_BASE_ADDR+(EE_CAL_OFFSET*cal_map)));
+        calMap[cal_map].calibration = param.calibration[cal_map];
         if ( !IsValidValForCal(cal_map) ) 
         {
             if (cal_map == ADC_ENUM_ALT_I) //channelToCalMap[ADC_CH_ALT_I].cal_map
@@ -160,12 +160,15 @@ void ChannelCalFromI2CtoEE(void)
                         // also clear the correct CAL_n_DEFAULT bit (calibration is not default)
                         uint8_t mask_for_cal_default_bit = ~(1<<adc_enum);
                         cal_loaded = cal_loaded & mask_for_cal_default_bit; // now clear the CAL_n_DEFAULT bit
+                        bump_analog_generation();
                         return; // all done
                     }
                 }
                 else
                 {
                     LoadCalFromEEPROM((ADC_ENUM_t) adc_enum); // ignore value since it is not valid
+                    cal_loaded = cal_loaded & 0x0F; // clear the CAL_n_TOSAVE bits so it is not loaded again
+                    bump_analog_generation();
                 }
             }       
         }
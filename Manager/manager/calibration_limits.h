@@ -5,7 +5,7 @@
 // use CAL_CH_enum for: CAL_CH_ALT_I, CAL_CH_ALT_V, CAL_CH_PWR_I, CAL_CH_PWR_V, CAL_CH_END
 #include "../lib/adc_bsd.h"
 
-//EEPROM memory usage (see README.md). 
+//EEPROM memory usage befor the journal (see param_store.h), it is copied once. 
 #define EE_CAL_BASE_ADDR 82
 // EEPROM byte offset to each calibration value
 #define EE_CAL_OFFSET 4
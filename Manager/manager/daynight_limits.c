@@ -35,8 +35,8 @@ SOFTWARE.
 #include <ctype.h>
 #include <avr/pgmspace.h>
 #include <util/atomic.h>
-#include <avr/eeprom.h> 
 #include "daynight_limits.h"
+#include "param_store.h"
 
 DAYNIGHT_t daynight_values_loaded;
 int daynight_morning_threshold;
@@ -116,83 +116,55 @@ uint8_t IsValidEveningDebounce(unsigned long *value)
     }
 }
 
-// wrtite daynight_morning_threshold (when morning debounce starts) to EEPROM
+// stage daynight_morning_threshold (when morning debounce starts) for the EEPROM journal
 uint8_t WriteEEMorningThreshold() 
 {
-    uint16_t tmp_daynight_morning_threshold= eeprom_read_word((uint16_t*)(EE_DAYNIGHT_ADDR+EE_DAYNIGHT_MORNING_THRESHOLD_OFFSET)); 
-    if ( eeprom_is_ready() )
+    if (param.daynight_morning_threshold != ((uint16_t)daynight_morning_threshold) )
     {
-        if (tmp_daynight_morning_threshold != ((uint16_t)daynight_morning_threshold) )
-        {
-            eeprom_update_word( (uint16_t *)(EE_DAYNIGHT_ADDR+EE_DAYNIGHT_MORNING_THRESHOLD_OFFSET), (uint16_t)daynight_morning_threshold);
-        }
-        return 1;
-    }
-    else
-    {
-        return 0;
+        param.daynight_morning_threshold = (uint16_t)daynight_morning_threshold;
+        param_stage(PARAM_DAYNIGHT_MORNING_THRESHOLD);
     }
+    return 1;
 }
 
-// wrtite daynight_evening_threshold (when evening debounce starts) to EEPROM
+// stage daynight_evening_threshold (when evening debounce starts) for the EEPROM journal
 uint8_t WriteEEEveningThreshold() 
 {
-    uint16_t tmp_daynight_evening_threshold= eeprom_read_word((uint16_t*)(EE_DAYNIGHT_ADDR+EE_DAYNIGHT_EVENING_THRESHOLD_OFFSET)); 
-    if ( eeprom_is_ready() )
+    if (param.daynight_evening_threshold != ((uint16_t)daynight_evening_threshold) )
     {
-        if (tmp_daynight_evening_threshold != ((uint16_t)daynight_evening_threshold) )
-        {
-            eeprom_update_word( (uint16_t *)(EE_DAYNIGHT_ADDR+EE_DAYNIGHT_EVENING_THRESHOLD_OFFSET), (uint16_t)daynight_evening_threshold);
-        }
-        return 1;
-    }
-    else
-    {
-        return 0;
+        param.daynight_evening_threshold = (uint16_t)daynight_evening_threshold;
+        param_stage(PARAM_DAYNIGHT_EVENING_THRESHOLD);
     }
+    return 1;
 }
 
-// wrtite daynight_morning_debounce (debounce time in milliseconds) to EEPROM
+// stage daynight_morning_debounce (debounce time in milliseconds) for the EEPROM journal
 uint8_t WriteEEMorningDebounce() 
 {
-    uint32_t tmp_daynight_morning_debounce= eeprom_read_dword((uint32_t*)(EE_DAYNIGHT_ADDR+EE_DAYNIGHT_MORNING_DEBOUNCE_OFFSET)); 
-    if ( eeprom_is_ready() )
+    if (param.daynight_morning_debounce != ((uint32_t)daynight_morning_debounce) )
     {
-        if (tmp_daynight_morning_debounce != ((uint32_t)daynight_morning_debounce) )
-        {
-            eeprom_update_dword( (uint32_t *)(EE_DAYNIGHT_ADDR+EE_DAYNIGHT_MORNING_DEBOUNCE_OFFSET), (uint32_t)daynight_morning_debounce);
-        }
-        return 1;
-    }
-    else
-    {
-        return 0;
+        param.daynight_morning_debounce = (uint32_t)daynight_morning_debounce;
+        param_stage(PARAM_DAYNIGHT_MORNING_DEBOUNCE);
     }
+    return 1;
 }
 
-// wrtite daynight_evening_debounce (debounce time in milliseconds) to EEPROM
+// stage daynight_evening_debounce (debounce time in milliseconds) for the EEPROM journal
 uint8_t WriteEEEveningDebounce() 
 {
-    uint32_t tmp_daynight_evening_debounce= eeprom_read_dword((uint32_t*)(EE_DAYNIGHT_ADDR+EE_DAYNIGHT_EVENING_DEBOUNCE_OFFSET)); 
-    if ( eeprom_is_ready() )
+    if (param.daynight_evening_debounce != ((uint32_t)daynight_evening_debounce) )
     {
-        if (tmp_daynight_evening_debounce != ((uint32_t)daynight_evening_debounce) )
-        {
-            eeprom_update_dword( (uint32_t *)(EE_DAYNIGHT_ADDR+EE_DAYNIGHT_EVENING_DEBOUNCE_OFFSET), (uint32_t)daynight_evening_debounce);
-        }
-        return 1;
-    }
-    else
-    {
-        return 0;
+        param.daynight_evening_debounce = (uint32_t)daynight_evening_debounce;
+        param_stage(PARAM_DAYNIGHT_EVENING_DEBOUNCE);
     }
+    return 1;
 }
 
-// load day-night state machine values from EEPROM (or set defaults)
+// load day-night state machine values from the EEPROM shadow (or set defaults)
 uint8_t LoadDayNightValuesFromEEPROM() 
 {
     uint8_t use_defaults = 0;
-    int tmp_daynight_morning_threshold = (int)(eeprom_read_word((uint16_t*)(EE_DAYNIGHT_ADDR+EE_DAYNIGHT_MORNING_THRESHOLD_OFFSET)));
+    int tmp_daynight_morning_threshold = (int)(param.daynight_morning_threshold);
     if ( IsValidMorningThresholdFor12V(&tmp_daynight_morning_threshold) || IsValidMorningThresholdFor24V(&tmp_daynight_morning_threshold) )
     {
         daynight_morning_threshold = tmp_daynight_morning_threshold; 
@@ -201,7 +173,7 @@ uint8_t LoadDayNightValuesFromEEPROM()
     {
         use_defaults = 1;
     }
-    int tmp_daynight_evening_threshold = (int)(eeprom_read_word((uint16_t*)(EE_DAYNIGHT_ADDR+EE_DAYNIGHT_EVENING_THRESHOLD_OFFSET)));
+    int tmp_daynight_evening_threshold = (int)(param.daynight_evening_threshold);
     if ( (IsValidEveningThresholdFor12V(&tmp_daynight_evening_threshold) || IsValidEveningThresholdFor24V(&tmp_daynight_evening_threshold)) )
     {
         daynight_evening_threshold = tmp_daynight_evening_threshold;
@@ -210,7 +182,7 @@ uint8_t LoadDayNightValuesFromEEPROM()
     {
         use_defaults = 1;
     }
-    unsigned long tmp_daynight_morning_debounce = (unsigned long)(eeprom_read_dword((uint32_t*)(EE_DAYNIGHT_ADDR+EE_DAYNIGHT_MORNING_DEBOUNCE_OFFSET)));
+    unsigned long tmp_daynight_morning_debounce = (unsigned long)(param.daynight_morning_debounce);
     if ( IsValidMorningDebounce(&tmp_daynight_morning_debounce) )
     {
         daynight_morning_debounce = tmp_daynight_morning_debounce;
@@ -219,7 +191,7 @@ uint8_t LoadDayNightValuesFromEEPROM()
     {
         use_defaults = 1;
     }
-    unsigned long tmp_daynight_evening_debounce = (unsigned long)(eeprom_read_dword((uint32_t*)(EE_DAYNIGHT_ADDR+EE_DAYNIGHT_EVENING_DEBOUNCE_OFFSET)));
+    unsigned long tmp_daynight_evening_debounce = (unsigned long)(param.daynight_evening_debounce);
     if ( IsValidEveningDebounce(&tmp_daynight_evening_debounce) )
     {
         daynight_evening_debounce = tmp_daynight_evening_debounce;
@@ -1,7 +1,7 @@
 #ifndef DayNight_limits_H
 #define DayNight_limits_H
 
-//References EEPROM memory usage. 
+//EEPROM memory usage befor the journal (see param_store.h), it is copied once. 
 #define EE_DAYNIGHT_ADDR 70
 // each setting is at this byte offset, threshold is 2 bytes, debounce is 4 bytes
 #define EE_DAYNIGHT_MORNING_THRESHOLD_OFFSET 0
@@ -44,6 +44,7 @@ SOFTWARE.
 #include "battery_manager.h"
 #include "daynight_limits.h"
 #include "daynight_state.h"
+#include "energy_counters.h"
 
 // allow some time for ALT_V to have valid data
 #define STARTUP_DELAY 11000UL
@@ -67,7 +68,6 @@ uint8_t daynight_callback_poke;
 uint8_t day_work_callback_route;
 uint8_t night_work_callback_route;
 uint8_t daynight_fail_reported;
-TWI0_LOOP_STATE_t loop_state;
 
 /* check for day-night state durring program looping  
     with low nibble of daynight_state: range 0..7
@@ -89,12 +89,6 @@ TWI0_LOOP_STATE_t loop_state;
 */
 void check_daynight(void)
 {
-    // TWI waiting to finish (ignore daynight changes while TWI is waiting)
-    if (i2c_callback_waiting(&loop_state)) return; 
-    
-    // if somthing else is using twi then my loop_state should allow getting to this, but I want to skip this state machine
-    if (i2c_is_in_use) return;
-
     // if daynight settins are changing skip this state machine
     if (daynight_values_loaded > DAYNIGHT_VALUES_DEFAULT) return;
 
@@ -103,8 +97,7 @@ void check_daynight(void)
     {
         if (daynight_callback_address && daynight_callback_route)
         {
-            if (loop_state == TWI0_LOOP_STATE_RAW) loop_state = TWI0_LOOP_STATE_INIT;
-            i2c_callback(daynight_callback_address, daynight_callback_route, daynight_state, &loop_state); // update application
+            i2c_callback(daynight_callback_address, daynight_callback_route, daynight_state); // update application
         }
         daynight_callback_poke = 0;
         if (daynight_state == DAYNIGHT_STATE_FAIL) 
@@ -129,8 +122,7 @@ void check_daynight(void)
                 daynight_state = DAYNIGHT_STATE_DAY;
                 if (daynight_callback_address && daynight_callback_route)
                 {
-                    if (loop_state == TWI0_LOOP_STATE_RAW) loop_state = TWI0_LOOP_STATE_INIT;
-                    i2c_callback(daynight_callback_address, daynight_callback_route, daynight_state, &loop_state); // update application
+                    i2c_callback(daynight_callback_address, daynight_callback_route, daynight_state); // update application
                 }
                 daynight_timer = milliseconds();
             } 
@@ -139,8 +131,7 @@ void check_daynight(void)
                 daynight_state = DAYNIGHT_STATE_NIGHT;
                 if (daynight_callback_address && daynight_callback_route)
                 {
-                    if (loop_state == TWI0_LOOP_STATE_RAW) loop_state = TWI0_LOOP_STATE_INIT;
-                    i2c_callback(daynight_callback_address, daynight_callback_route, daynight_state, &loop_state); // update application
+                    i2c_callback(daynight_callback_address, daynight_callback_route, daynight_state); // update application
                 }
                 daynight_timer = milliseconds();
             }
@@ -152,8 +143,7 @@ void check_daynight(void)
             daynight_state = DAYNIGHT_STATE_EVENING_DEBOUNCE;
             if (daynight_callback_address && daynight_callback_route)
             {
-                if (loop_state == TWI0_LOOP_STATE_RAW) loop_state = TWI0_LOOP_STATE_INIT;
-                i2c_callback(daynight_callback_address, daynight_callback_route, daynight_state, &loop_state); // update application
+                i2c_callback(daynight_callback_address, daynight_callback_route, daynight_state); // update application
             }
             daynight_timer = milliseconds();
         }
@@ -162,8 +152,7 @@ void check_daynight(void)
             daynight_state = DAYNIGHT_STATE_FAIL;
             if (daynight_callback_address && daynight_callback_route)
             {
-                if (loop_state == TWI0_LOOP_STATE_RAW) loop_state = TWI0_LOOP_STATE_INIT;
-                i2c_callback(daynight_callback_address, daynight_callback_route, daynight_state, &loop_state); // update remote
+                i2c_callback(daynight_callback_address, daynight_callback_route, daynight_state); // update remote
             }
             daynight_fail_reported = 0;
             daynight_timer = milliseconds();
@@ -177,9 +166,8 @@ void check_daynight(void)
                 daynight_state = DAYNIGHT_STATE_NIGHTWORK;
                 if (daynight_callback_address && daynight_callback_route)
                 {
-                    if (loop_state == TWI0_LOOP_STATE_RAW) loop_state = TWI0_LOOP_STATE_INIT;
                     // remote daynight_state gets DAYNIGHT_STATE_NIGHT while DAYNIGHT_NIGHTWORK_STATE is used to operate night_work_callback_route
-                    i2c_callback(daynight_callback_address, daynight_callback_route, DAYNIGHT_STATE_NIGHT, &loop_state); // update remote
+                    i2c_callback(daynight_callback_address, daynight_callback_route, DAYNIGHT_STATE_NIGHT); // update remote
                 }
                 daynight_timer = milliseconds();
             } 
@@ -189,8 +177,7 @@ void check_daynight(void)
             daynight_state = DAYNIGHT_STATE_DAY;
             if (daynight_callback_address && daynight_callback_route)
             {
-                if (loop_state == TWI0_LOOP_STATE_RAW) loop_state = TWI0_LOOP_STATE_INIT;
-                i2c_callback(daynight_callback_address, daynight_callback_route, daynight_state, &loop_state); // update remote
+                i2c_callback(daynight_callback_address, daynight_callback_route, daynight_state); // update remote
             }
             daynight_timer = milliseconds();
         }
@@ -199,11 +186,11 @@ void check_daynight(void)
         daynight_state = DAYNIGHT_STATE_NIGHT;
         if (daynight_callback_address && night_work_callback_route)
         {
-            if (loop_state == TWI0_LOOP_STATE_RAW) loop_state = TWI0_LOOP_STATE_INIT;
-            i2c_callback(daynight_callback_address, night_work_callback_route, DAYNIGHT_STATE_NIGHTWORK, &loop_state); // night_work_callback remote
+            i2c_callback(daynight_callback_address, night_work_callback_route, DAYNIGHT_STATE_NIGHTWORK); // night_work_callback remote
         }
         accumulate_alt_mega_ti_at_night = accumulate_alt_mega_ti;
         accumulate_pwr_mega_ti_at_night = accumulate_pwr_mega_ti;
+        energy_snapshot(ENERGY_SET_AT_NIGHT);
         daynight_timer_at_night = milliseconds();
         break;
     case DAYNIGHT_STATE_NIGHT:
@@ -212,8 +199,7 @@ void check_daynight(void)
             daynight_state = DAYNIGHT_STATE_MORNING_DEBOUNCE;
             if (daynight_callback_address && daynight_callback_route)
             {
-                if (loop_state == TWI0_LOOP_STATE_RAW) loop_state = TWI0_LOOP_STATE_INIT;
-                i2c_callback(daynight_callback_address, daynight_callback_route, daynight_state, &loop_state); // update remote
+                i2c_callback(daynight_callback_address, daynight_callback_route, daynight_state); // update remote
             }
             daynight_timer = milliseconds();
         }
@@ -222,8 +208,7 @@ void check_daynight(void)
             daynight_state = DAYNIGHT_STATE_FAIL;
             if (daynight_callback_address && daynight_callback_route)
             {
-                if (loop_state == TWI0_LOOP_STATE_RAW) loop_state = TWI0_LOOP_STATE_INIT;
-                i2c_callback(daynight_callback_address, daynight_callback_route, daynight_state, &loop_state); // update remote
+                i2c_callback(daynight_callback_address, daynight_callback_route, daynight_state); // update remote
             }
             daynight_timer = milliseconds();
         }
@@ -236,9 +221,8 @@ void check_daynight(void)
                 daynight_state = DAYNIGHT_STATE_DAYWORK;
                 if (daynight_callback_address && daynight_callback_route)
                 {
-                    if (loop_state == TWI0_LOOP_STATE_RAW) loop_state = TWI0_LOOP_STATE_INIT;
                     // remote daynight_state gets DAYNIGHT_STATE_DAY while DAYNIGHT_STATE_DAYWORK is used to operate day_work_callback_route
-                    i2c_callback(daynight_callback_address, daynight_callback_route, DAYNIGHT_STATE_DAY, &loop_state); // update remote
+                    i2c_callback(daynight_callback_address, daynight_callback_route, DAYNIGHT_STATE_DAY); // update remote
                 }
                 daynight_timer = milliseconds();
             }
@@ -248,8 +232,7 @@ void check_daynight(void)
             daynight_state = DAYNIGHT_STATE_NIGHT;
             if (daynight_callback_address && daynight_callback_route)
             {
-                if (loop_state == TWI0_LOOP_STATE_RAW) loop_state = TWI0_LOOP_STATE_INIT;
-                i2c_callback(daynight_callback_address, daynight_callback_route, daynight_state, &loop_state); // update remote
+                i2c_callback(daynight_callback_address, daynight_callback_route, daynight_state); // update remote
             }
             daynight_timer = milliseconds();
         }
@@ -258,22 +241,21 @@ void check_daynight(void)
         daynight_state = DAYNIGHT_STATE_DAY; // update local
         if (daynight_callback_address && day_work_callback_route)
         {
-            if (loop_state == TWI0_LOOP_STATE_RAW) loop_state = TWI0_LOOP_STATE_INIT;
-            i2c_callback(daynight_callback_address, day_work_callback_route, DAYNIGHT_STATE_DAYWORK, &loop_state); // day_work_callback remote
+            i2c_callback(daynight_callback_address, day_work_callback_route, DAYNIGHT_STATE_DAYWORK); // day_work_callback remote
         }
         alt_pwm_accum_charge_time = 0; // clear charge time
         accumulate_alt_mega_ti_at_day = accumulate_alt_mega_ti;
         accumulate_pwr_mega_ti_at_day = accumulate_pwr_mega_ti;
+        energy_snapshot(ENERGY_SET_AT_DAY);
         daynight_timer_at_day = milliseconds();
         return;
         break;
     case DAYNIGHT_STATE_FAIL: 
-        if (daynight_fail_reported);
+        if (!daynight_fail_reported)
         {
             if (daynight_callback_address && daynight_callback_route)
             {
-                if (loop_state == TWI0_LOOP_STATE_RAW) loop_state = TWI0_LOOP_STATE_INIT;
-                i2c_callback(daynight_callback_address, daynight_callback_route, daynight_state, &loop_state); // update remote
+                i2c_callback(daynight_callback_address, daynight_callback_route, daynight_state); // update remote
             }
             daynight_fail_reported = 1;
         }
@@ -58,6 +58,7 @@ uint8_t my_mcu_is_target_and_i_have_it_reset;
 
 void check_DTR(void)
 {
+    if (test_mode) return; // test_mode has the transceivers
     if (!host_is_foreign) 
     {
         if ( !ioRead(MCU_IO_HOST_nRTS) )  // if HOST_nRTS is set (active low) then assume avrdude wants to use the bootloader
@@ -0,0 +1,125 @@
+/*
+energy_counters integrates charge and energy for the ALT and PWR inputs
+Copyright (C) 2020 Ronald Sutherland
+
+All rights reserved, specifically, the right to Redistribut is withheld. Subject 
+to your compliance with these terms, you may use this software and derivatives. 
+
+Use in source and binary forms, with or without modification, are permitted 
+provided that the following conditions are met:
+1. Source code must retain the above copyright notice, this list of 
+conditions and the following disclaimer.
+2. Binary derivatives are exclusively for use with Ronald Sutherland 
+products.
+3. Neither the name of the copyright holders nor the names of its
+contributors may be used to endorse or promote products derived from
+this software without specific prior written permission.
+
+THIS SOFTWARE IS SUPPLIED BY RONALD SUTHERLAND "AS IS". NO WARRANTIES, WHETHER
+EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY
+IMPLIED WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS
+FOR A PARTICULAR PURPOSE.
+
+IN NO EVENT WILL RONALD SUTHERLAND BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF RONALD SUTHERLAND
+HAS BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO
+THE FULLEST EXTENT ALLOWED BY LAW, RONALD SUTHERLAND'S TOTAL LIABILITY ON ALL
+CLAIMS IN ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT
+OF FEES, IF ANY, THAT YOU HAVE PAID DIRECTLY TO RONALD SUTHERLAND FOR THIS
+SOFTWARE.
+*/
+
+#include <avr/io.h>
+#include "../lib/adc_bsd.h"
+#include "references.h"
+#include "calibration_limits.h"
+#include "adc_burst.h"
+#include "energy_counters.h"
+
+ENERGY_COUNTER_t energy_counter[ENERGY_SETS][ENERGY_INPUTS];
+
+// a burst is ADC_DELAY_MILSEC (10mSec), so 360000 bursts of one uA is one uAh (and of one uW is one uWh)
+#define BURSTS_PER_MICRO_HOUR (3600000UL / ADC_DELAY_MILSEC)
+
+// what is left over until the next uAh or uWh
+static uint32_t charge_balance[ENERGY_INPUTS];
+static uint32_t energy_balance[ENERGY_INPUTS];
+
+// fixed point scales from the reference and calibrations, updated when analog_generation or adc_oversample_bits change
+static uint32_t current_scale[ENERGY_INPUTS]; // uA per decimated count (Q8)
+static uint32_t power_scale[ENERGY_INPUTS]; // uW per decimated count of current times count of voltage (Q16)
+static uint8_t scale_generation = ANALOG_GENERATION_NONE;
+static uint8_t scale_bits = 0xFF;
+
+const static struct {
+    ADC_ENUM_t current;
+    ADC_ENUM_t voltage;
+} energyMap[ENERGY_INPUTS] = {
+    [ENERGY_INPUT_ALT] = { .current = ADC_ENUM_ALT_I, .voltage = ADC_ENUM_ALT_V },
+    [ENERGY_INPUT_PWR] = { .current = ADC_ENUM_PWR_I, .voltage = ADC_ENUM_PWR_V }
+};
+
+// float math is only done when a reference or calibration has changed
+static void energy_scale(void)
+{
+    float counts = (float) (1UL<<adc_oversample_bits);
+    float ref = refMap[REFERENCE_EXTERN_AVCC].reference;
+    for (uint8_t input = 0; input < ENERGY_INPUTS; input++)
+    {
+        float uA_per_count = ref * calMap[energyMap[input].current].calibration * 1.0E6 / counts;
+        float mV_per_count = ref * calMap[energyMap[input].voltage].calibration * 1.0E3 / counts;
+        current_scale[input] = (uint32_t) (uA_per_count * 256.0 + 0.5);
+        power_scale[input] = (uint32_t) (uA_per_count * mV_per_count / 1000.0 * 65536.0 + 0.5);
+    }
+    scale_generation = analog_generation;
+    scale_bits = adc_oversample_bits;
+}
+
+// a reading is placed in the middle of its LSB (like add_half_LSB_every_other_accumulation), 
+// it is returned in units of half a decimated count.
+static uint16_t reading_x2(ADC_ENUM_t adc_enum)
+{
+    return (adcDecimatedAtomic(adcMap[adc_enum].channel)<<1) + (1<<adc_oversample_bits);
+}
+
+// call once for each adc burst (every ADC_DELAY_MILSEC)
+void energy_update(void)
+{
+    if ( (scale_generation != analog_generation) || (scale_bits != adc_oversample_bits) ) energy_scale();
+    for (uint8_t input = 0; input < ENERGY_INPUTS; input++)
+    {
+        uint16_t i_x2 = reading_x2(energyMap[input].current);
+        uint16_t v_x2 = reading_x2(energyMap[input].voltage);
+        // the default ALT_I calibration already puts this product near 2**31, so do it in 64 bits
+        uint32_t current_uA = (uint32_t) ( ((uint64_t) i_x2 * current_scale[input]) >> 9 );
+        uint32_t power_uW = (uint32_t) ( ((uint64_t) ((uint32_t) i_x2 * v_x2) * power_scale[input]) >> 18 );
+
+        charge_balance[input] += current_uA;
+        if (charge_balance[input] >= BURSTS_PER_MICRO_HOUR)
+        {
+            uint32_t whole = charge_balance[input] / BURSTS_PER_MICRO_HOUR;
+            energy_counter[ENERGY_SET_NOW][input].charge_uAh += whole;
+            charge_balance[input] -= whole * BURSTS_PER_MICRO_HOUR;
+        }
+        // ALT_V is not converted while ALT_EN is set, the energy is held rather than counted with an old voltage
+        if ( (input == ENERGY_INPUT_ALT) && adc_alt_v_stale ) continue;
+        energy_balance[input] += power_uW;
+        if (energy_balance[input] >= BURSTS_PER_MICRO_HOUR)
+        {
+            uint32_t whole = energy_balance[input] / BURSTS_PER_MICRO_HOUR;
+            energy_counter[ENERGY_SET_NOW][input].energy_uWh += whole;
+            energy_balance[input] -= whole * BURSTS_PER_MICRO_HOUR;
+        }
+    }
+}
+
+// copy the running counters, e.g., at the day work or night work event
+void energy_snapshot(ENERGY_SET_t set)
+{
+    if ( (set == ENERGY_SET_NOW) || (set >= ENERGY_SETS) ) return;
+    for (uint8_t input = 0; input < ENERGY_INPUTS; input++)
+    {
+        energy_counter[set][input] = energy_counter[ENERGY_SET_NOW][input];
+    }
+}
@@ -0,0 +1,30 @@
+#ifndef Energy_Counters_H
+#define Energy_Counters_H
+
+// inputs that have a current and a voltage channel
+typedef enum ENERGY_INPUT_enum {
+    ENERGY_INPUT_ALT, // ALT_I and ALT_V, e.g., from a charger
+    ENERGY_INPUT_PWR, // PWR_I and PWR_V, what the board uses
+    ENERGY_INPUTS
+} ENERGY_INPUT_t;
+
+// sets of counters: the running count, and copies taken at the day work and night work events
+typedef enum ENERGY_SET_enum {
+    ENERGY_SET_NOW,
+    ENERGY_SET_AT_DAY,
+    ENERGY_SET_AT_NIGHT,
+    ENERGY_SETS
+} ENERGY_SET_t;
+
+// counters are in calibrated units, they will not roll over (48 bits are returned over I2C)
+typedef struct {
+    uint64_t charge_uAh;
+    uint64_t energy_uWh;
+} ENERGY_COUNTER_t;
+
+extern ENERGY_COUNTER_t energy_counter[ENERGY_SETS][ENERGY_INPUTS];
+
+extern void energy_update(void);
+extern void energy_snapshot(ENERGY_SET_t set);
+
+#endif // Energy_Counters_H 
@@ -35,8 +35,8 @@ SOFTWARE.
 #include <ctype.h>
 #include <avr/pgmspace.h>
 #include <util/atomic.h>
-#include <avr/eeprom.h> 
 #include "host_shutdown_limits.h"
+#include "param_store.h"
 
 HOSTSHUTDOWN_LIM_t shutdown_limit_loaded;
 int shutdown_halt_curr_limit;
@@ -92,69 +92,45 @@ uint8_t IsValidShtDwnWearleveling(unsigned long *value)
     }
 }
 
-// befor host shutdown is done PWR_I current must be bellow this, save it to EEPROM
+// befor host shutdown is done PWR_I current must be bellow this, stage it for the EEPROM journal
 uint8_t WriteEEShtDwnHaltCurr() 
 {
-    if ( eeprom_is_ready() )
-    {
-        eeprom_update_word( (uint16_t *)(EE_HOSTSHUTDOWN_LIMIT_ADDR+EE_HOSTSHUTDOWN_LIM_HALTCURR_LIMIT), (uint16_t)shutdown_halt_curr_limit);
-        return 1;
-    }
-    else
-    {
-        return 0;
-    }
+    param.shutdown_halt_curr_limit = (uint16_t)shutdown_halt_curr_limit;
+    param_stage(PARAM_SHUTDOWN_HALT_CURR);
+    return 1;
 }
 
-// time to wait for PWR_I to be bellow shutdown_halt_curr_limit and stable for wearleveling, save it to EEPROM
+// time to wait for PWR_I to be bellow shutdown_halt_curr_limit and stable for wearleveling, stage it for the EEPROM journal
 uint8_t WriteEEShtDwnHaltTTL() 
 {
-    if ( eeprom_is_ready() )
-    {
-        eeprom_update_dword( (uint32_t *)(EE_HOSTSHUTDOWN_LIMIT_ADDR+EE_HOSTSHUTDOWN_LIM_HALT_TTL), (uint32_t)shutdown_ttl_limit);
-        return 1;
-    }
-    else
-    {
-        return 0;
-    }
+    param.shutdown_ttl_limit = (uint32_t)shutdown_ttl_limit;
+    param_stage(PARAM_SHUTDOWN_HALT_TTL);
+    return 1;
 }
 
-// time to wait after halt current is valid, but befor checking wearleveling for stable readings, save it to EEPROM
+// time to wait after halt current is valid, but befor checking wearleveling for stable readings, stage it for the EEPROM journal
 uint8_t WriteEEShtDwnDelay() 
 {
-    if ( eeprom_is_ready() )
-    {
-        eeprom_update_dword( (uint32_t *)(EE_HOSTSHUTDOWN_LIMIT_ADDR+EE_HOSTSHUTDOWN_LIM_DELAY), (uint32_t)shutdown_delay_limit);
-        return 1;
-    }
-    else
-    {
-        return 0;
-    }
+    param.shutdown_delay_limit = (uint32_t)shutdown_delay_limit;
+    param_stage(PARAM_SHUTDOWN_DELAY);
+    return 1;
 }
 
-// time PWR_I must be stable befor power down, save it to EEPROM
+// time PWR_I must be stable befor power down, stage it for the EEPROM journal
 uint8_t WriteEEShtDwnWearleveling() 
 {
-    if ( eeprom_is_ready() )
-    {
-        eeprom_update_dword( (uint32_t *)(EE_HOSTSHUTDOWN_LIMIT_ADDR+EE_HOSTSHUTDOWN_LIM_WEARLEVELING), (uint32_t)shutdown_wearleveling_limit);
-        return 1;
-    }
-    else
-    {
-        return 0;
-    }
+    param.shutdown_wearleveling_limit = (uint32_t)shutdown_wearleveling_limit;
+    param_stage(PARAM_SHUTDOWN_WEARLEVELING);
+    return 1;
 }
 
-// load Shutdown Limits from EEPROM (or set defaults)
+// load Shutdown Limits from the EEPROM shadow (or set defaults)
 uint8_t LoadShtDwnLimitsFromEEPROM() 
 {
-    int tmp_shutdown_halt_curr_limit = eeprom_read_word((uint16_t*)(EE_HOSTSHUTDOWN_LIMIT_ADDR+EE_HOSTSHUTDOWN_LIM_HALTCURR_LIMIT));
-    unsigned long temp_shutdown_ttl_limit = eeprom_read_dword((uint32_t*)(EE_HOSTSHUTDOWN_LIMIT_ADDR+EE_HOSTSHUTDOWN_LIM_HALT_TTL));
-    unsigned long temp_shutdown_delay_limit = eeprom_read_dword((uint32_t*)(EE_HOSTSHUTDOWN_LIMIT_ADDR+EE_HOSTSHUTDOWN_LIM_DELAY));
-    unsigned long temp_shutdown_wearleveling_limit = eeprom_read_dword((uint32_t*)(EE_HOSTSHUTDOWN_LIMIT_ADDR+EE_HOSTSHUTDOWN_LIM_WEARLEVELING));
+    int tmp_shutdown_halt_curr_limit = param.shutdown_halt_curr_limit;
+    unsigned long temp_shutdown_ttl_limit = param.shutdown_ttl_limit;
+    unsigned long temp_shutdown_delay_limit = param.shutdown_delay_limit;
+    unsigned long temp_shutdown_wearleveling_limit = param.shutdown_wearleveling_limit;
     uint8_t use_defauts = 0;
     // opps, I did not have "not" (!) in front of each test and was loading uninitialized EEPROM into the values rather than using the defaults. 
     if (!IsValidShtDwnHaltCurr(&tmp_shutdown_halt_curr_limit)) use_defauts = 1; 
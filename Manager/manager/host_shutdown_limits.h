@@ -1,7 +1,7 @@
 #ifndef Host_Shutdown_limits_H
 #define Host_Shutdown_limits_H
 
-//References EEPROM memory usage. 
+//EEPROM memory usage befor the journal (see param_store.h), it is copied once. 
 #define EE_HOSTSHUTDOWN_LIMIT_ADDR 130
 // each setting is at this byte offset
 #define EE_HOSTSHUTDOWN_LIM_HALTCURR_LIMIT 0
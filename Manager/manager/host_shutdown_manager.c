@@ -55,7 +55,6 @@ uint8_t shutdown_callback_address;
 uint8_t shutdown_callback_route;
 uint8_t shutdown_callback_poke;
 uint8_t shutdown_bringuphost;
-TWI0_LOOP_STATE_t loop_state;
 
 uint8_t fail_wip;
 uint8_t resume_bm_enable;
@@ -66,12 +65,6 @@ int last_pwr_i;
 // shutdown_callback_address must be set for application to get events
 void check_if_host_should_be_on(void)
 {
-    // TWI waiting to finish (ignore changes while TWI is waiting)
-    if (i2c_callback_waiting(&loop_state)) return; 
-    
-    // if somthing else is using twi then my loop_state will allow getting to this, but I want to skip the state machine
-    if (i2c_is_in_use) return;
-
     // if host_shutdown limits are changing skip this state machine
     if (shutdown_limit_loaded > HOSTSHUTDOWN_LIM_DEFAULT) return;
 
@@ -80,8 +73,7 @@ void check_if_host_should_be_on(void)
     {
         if (shutdown_callback_address && shutdown_callback_route)
         {
-            if (loop_state == TWI0_LOOP_STATE_RAW) loop_state = TWI0_LOOP_STATE_INIT;
-            i2c_callback(shutdown_callback_address, shutdown_callback_route, shutdown_state, &loop_state); // update application
+            i2c_callback(shutdown_callback_address, shutdown_callback_route, shutdown_state); // update application
         }
         shutdown_callback_poke = 0;
         return;
@@ -97,8 +89,7 @@ void check_if_host_should_be_on(void)
             ioWrite(MCU_IO_SHUTDOWN, LOGIC_LEVEL_HIGH); // enable pull up
             if (shutdown_callback_address && shutdown_callback_route)
             {
-                if (loop_state == TWI0_LOOP_STATE_RAW) loop_state = TWI0_LOOP_STATE_INIT;
-                i2c_callback(shutdown_callback_address, shutdown_callback_route, shutdown_state, &loop_state); // update application
+                i2c_callback(shutdown_callback_address, shutdown_callback_route, shutdown_state); // update application
             }
             return;
         }
@@ -112,8 +103,7 @@ void check_if_host_should_be_on(void)
             shutdown_state = HOSTSHUTDOWN_STATE_SW_HALT;
             if (shutdown_callback_address && shutdown_callback_route)
             {
-                if (loop_state == TWI0_LOOP_STATE_RAW) loop_state = TWI0_LOOP_STATE_INIT;
-                i2c_callback(shutdown_callback_address, shutdown_callback_route, shutdown_state, &loop_state); // update application
+                i2c_callback(shutdown_callback_address, shutdown_callback_route, shutdown_state); // update application
             }
             return;
         }
@@ -134,8 +124,7 @@ void check_if_host_should_be_on(void)
                 shutdown_state = HOSTSHUTDOWN_STATE_HALT;
                 if (shutdown_callback_address && shutdown_callback_route)
                 {
-                    if (loop_state == TWI0_LOOP_STATE_RAW) loop_state = TWI0_LOOP_STATE_INIT;
-                    i2c_callback(shutdown_callback_address, shutdown_callback_route, shutdown_state, &loop_state); // update application
+                    i2c_callback(shutdown_callback_address, shutdown_callback_route, shutdown_state); // update application
                 }
             }
         }
@@ -153,8 +142,7 @@ void check_if_host_should_be_on(void)
         shutdown_state = HOSTSHUTDOWN_STATE_HALT;
         if (shutdown_callback_address && shutdown_callback_route)
         {
-            if (loop_state == TWI0_LOOP_STATE_RAW) loop_state = TWI0_LOOP_STATE_INIT;
-            i2c_callback(shutdown_callback_address, shutdown_callback_route, shutdown_state, &loop_state); // update application
+            i2c_callback(shutdown_callback_address, shutdown_callback_route, shutdown_state); // update application
         }
         break;
 
@@ -166,8 +154,7 @@ void check_if_host_should_be_on(void)
             shutdown_state = HOSTSHUTDOWN_STATE_CURR_CHK;
             if (shutdown_callback_address && shutdown_callback_route)
             {
-                if (loop_state == TWI0_LOOP_STATE_RAW) loop_state = TWI0_LOOP_STATE_INIT;
-                i2c_callback(shutdown_callback_address, shutdown_callback_route, shutdown_state, &loop_state); // update application
+                i2c_callback(shutdown_callback_address, shutdown_callback_route, shutdown_state); // update application
             }
         }
         break;
@@ -179,8 +166,7 @@ void check_if_host_should_be_on(void)
             shutdown_state = HOSTSHUTDOWN_STATE_AT_HALT_CURR;
             if (shutdown_callback_address && shutdown_callback_route)
             {
-                if (loop_state == TWI0_LOOP_STATE_RAW) loop_state = TWI0_LOOP_STATE_INIT;
-                i2c_callback(shutdown_callback_address, shutdown_callback_route, shutdown_state, &loop_state); // update application
+                i2c_callback(shutdown_callback_address, shutdown_callback_route, shutdown_state); // update application
             }
         }
         else 
@@ -190,8 +176,7 @@ void check_if_host_should_be_on(void)
                     shutdown_state = HOSTSHUTDOWN_STATE_HALTTIMEOUT_RESET_APP;
                     if (shutdown_callback_address && shutdown_callback_route)
                     {
-                        if (loop_state == TWI0_LOOP_STATE_RAW) loop_state = TWI0_LOOP_STATE_INIT;
-                        i2c_callback(shutdown_callback_address, shutdown_callback_route, shutdown_state, &loop_state); // update application
+                        i2c_callback(shutdown_callback_address, shutdown_callback_route, shutdown_state); // update application
                     }
                 }
             }
@@ -204,8 +189,7 @@ void check_if_host_should_be_on(void)
         shutdown_state = HOSTSHUTDOWN_STATE_FAIL;
         if (shutdown_callback_address && shutdown_callback_route)
         {
-            if (loop_state == TWI0_LOOP_STATE_RAW) loop_state = TWI0_LOOP_STATE_INIT;
-            i2c_callback(shutdown_callback_address, shutdown_callback_route, shutdown_state, &loop_state); // update application
+            i2c_callback(shutdown_callback_address, shutdown_callback_route, shutdown_state); // update application
         }
         break;
 
@@ -214,8 +198,7 @@ void check_if_host_should_be_on(void)
         shutdown_state = HOSTSHUTDOWN_STATE_DELAY;
         if (shutdown_callback_address && shutdown_callback_route)
         {
-            if (loop_state == TWI0_LOOP_STATE_RAW) loop_state = TWI0_LOOP_STATE_INIT;
-            i2c_callback(shutdown_callback_address, shutdown_callback_route, shutdown_state, &loop_state); // update application
+            i2c_callback(shutdown_callback_address, shutdown_callback_route, shutdown_state); // update application
         }
         break;
 
@@ -225,8 +208,7 @@ void check_if_host_should_be_on(void)
             shutdown_state = HOSTSHUTDOWN_STATE_WEARLEVELING;
             if (shutdown_callback_address && shutdown_callback_route)
             {
-                if (loop_state == TWI0_LOOP_STATE_RAW) loop_state = TWI0_LOOP_STATE_INIT;
-                i2c_callback(shutdown_callback_address, shutdown_callback_route, shutdown_state, &loop_state); // update application
+                i2c_callback(shutdown_callback_address, shutdown_callback_route, shutdown_state); // update application
             }
         }
         break;
@@ -244,8 +226,7 @@ void check_if_host_should_be_on(void)
                 shutdown_wearleveling_done_at = milliseconds();
                 if (shutdown_callback_address && shutdown_callback_route)
                 {
-                    if (loop_state == TWI0_LOOP_STATE_RAW) loop_state = TWI0_LOOP_STATE_INIT;
-                    i2c_callback(shutdown_callback_address, shutdown_callback_route, shutdown_state, &loop_state); // update application
+                    i2c_callback(shutdown_callback_address, shutdown_callback_route, shutdown_state); // update application
                 }
             }
         }
@@ -264,8 +245,7 @@ void check_if_host_should_be_on(void)
                 shutdown_state = HOSTSHUTDOWN_STATE_RESTART;
                 if (shutdown_callback_address && shutdown_callback_route)
                 {
-                    if (loop_state == TWI0_LOOP_STATE_RAW) loop_state = TWI0_LOOP_STATE_INIT;
-                    i2c_callback(shutdown_callback_address, shutdown_callback_route, shutdown_state, &loop_state); // update application
+                    i2c_callback(shutdown_callback_address, shutdown_callback_route, shutdown_state); // update application
                 }
             }
         }
@@ -287,8 +267,7 @@ void check_if_host_should_be_on(void)
                 ioWrite(MCU_IO_SHUTDOWN, LOGIC_LEVEL_HIGH); // lockout manual shutdown switch
                 if (shutdown_callback_address && shutdown_callback_route)
                 {
-                    if (loop_state == TWI0_LOOP_STATE_RAW) loop_state = TWI0_LOOP_STATE_INIT;
-                    i2c_callback(shutdown_callback_address, shutdown_callback_route, shutdown_state, &loop_state); // update application
+                    i2c_callback(shutdown_callback_address, shutdown_callback_route, shutdown_state); // update application
                 }
             }
         }
@@ -306,8 +285,7 @@ void check_if_host_should_be_on(void)
             ioWrite(MCU_IO_SHUTDOWN, LOGIC_LEVEL_HIGH); // enable manual shutdown switch (with weak pull up)
             if (shutdown_callback_address && shutdown_callback_route)
             {
-                if (loop_state == TWI0_LOOP_STATE_RAW) loop_state = TWI0_LOOP_STATE_INIT;
-                i2c_callback(shutdown_callback_address, shutdown_callback_route, shutdown_state, &loop_state); // update application
+                i2c_callback(shutdown_callback_address, shutdown_callback_route, shutdown_state); // update application
             }
         }
         break;
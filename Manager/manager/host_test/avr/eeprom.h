@@ -0,0 +1,64 @@
+#ifndef HostTest_Eeprom_h
+#define HostTest_Eeprom_h
+
+// EEPROM is an array the test owns, power_left counts the bytes that can be burned befor the power is cut.
+// The byte being burned when the power is cut is left with a random value.
+
+#include <stdint.h>
+#include <stddef.h>
+#include <stdlib.h>
+#include <string.h>
+
+extern uint8_t ee[E2END + 1];
+extern uint8_t ee_busy;
+extern long power_left;
+
+#define EE_INDEX(address) ((uintptr_t) (address))
+
+static inline uint8_t eeprom_read_byte(const uint8_t *address)
+{
+    return ee[EE_INDEX(address)];
+}
+
+static inline uint16_t eeprom_read_word(const uint16_t *address)
+{
+    uint16_t value;
+    memcpy(&value, &ee[EE_INDEX(address)], sizeof(value));
+    return value;
+}
+
+static inline uint32_t eeprom_read_dword(const uint32_t *address)
+{
+    uint32_t value;
+    memcpy(&value, &ee[EE_INDEX(address)], sizeof(value));
+    return value;
+}
+
+static inline float eeprom_read_float(const float *address)
+{
+    float value;
+    memcpy(&value, &ee[EE_INDEX(address)], sizeof(value));
+    return value;
+}
+
+static inline void eeprom_read_block(void *dst, const void *src, size_t n)
+{
+    memcpy(dst, &ee[EE_INDEX(src)], n);
+}
+
+static inline void eeprom_update_byte(uint8_t *address, uint8_t value)
+{
+    if (power_left <= 0) return;
+    if (ee[EE_INDEX(address)] == value) return;
+    if (--power_left == 0)
+    {
+        ee[EE_INDEX(address)] = (uint8_t) rand(); // cut during the burn
+        return;
+    }
+    ee[EE_INDEX(address)] = value;
+    ee_busy = 1;
+}
+
+#define eeprom_is_ready() ((power_left > 0) && !ee_busy)
+
+#endif // HostTest_Eeprom_h
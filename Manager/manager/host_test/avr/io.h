@@ -0,0 +1,10 @@
+#ifndef HostTest_Io_h
+#define HostTest_Io_h
+
+// the manager is a 328pb, adc_bsd.h picks its channels from this
+#define _AVR_ATMEGA328PB_H_INCLUDED
+#define E2END 1023
+
+#include <stdint.h>
+
+#endif // HostTest_Io_h
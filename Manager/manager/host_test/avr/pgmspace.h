@@ -0,0 +1,9 @@
+#ifndef HostTest_Pgmspace_h
+#define HostTest_Pgmspace_h
+
+// flash is plain memory on the host
+#include <string.h>
+#define PROGMEM
+#define memcpy_P memcpy
+
+#endif // HostTest_Pgmspace_h
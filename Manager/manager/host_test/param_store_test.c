@@ -0,0 +1,150 @@
+/*
+host test of param_store.c, the power is cut at a random byte of a commit
+Copyright (C) 2020 Ronald Sutherland
+
+All rights reserved, specifically, the right to Redistribut is withheld. Subject 
+to your compliance with these terms, you may use this software and derivatives. 
+
+Use in source and binary forms, with or without modification, are permitted 
+provided that the following conditions are met:
+1. Source code must retain the above copyright notice, this list of 
+conditions and the following disclaimer.
+2. Binary derivatives are exclusively for use with Ronald Sutherland 
+products.
+3. Neither the name of the copyright holders nor the names of its
+contributors may be used to endorse or promote products derived from
+this software without specific prior written permission.
+
+THIS SOFTWARE IS SUPPLIED BY RONALD SUTHERLAND "AS IS". NO WARRANTIES, WHETHER
+EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY
+IMPLIED WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS
+FOR A PARTICULAR PURPOSE.
+
+IN NO EVENT WILL RONALD SUTHERLAND BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF RONALD SUTHERLAND
+HAS BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO
+THE FULLEST EXTENT ALLOWED BY LAW, RONALD SUTHERLAND'S TOTAL LIABILITY ON ALL
+CLAIMS IN ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT
+OF FEES, IF ANY, THAT YOU HAVE PAID DIRECTLY TO RONALD SUTHERLAND FOR THIS
+SOFTWARE.
+
+The Makefile builds this with F_CPU set and -fpack-struct like the manager, e.g., make test
+*/
+#include <stdio.h>
+#include <stdint.h>
+#include <stdlib.h>
+#include <string.h>
+#include "../param_store.c"
+
+uint8_t ee[E2END + 1];
+uint8_t ee_busy;
+long power_left;
+
+#define POWER_ON 0x7FFFFFFFL
+
+// param_store.c also needs these from the manager
+static unsigned long now;
+unsigned long milliseconds(void)
+{
+    return now;
+}
+unsigned long elapsed(unsigned long *past)
+{
+    return now - *past;
+}
+uint8_t check_for_eeprom_id(void)
+{
+    return 0;
+}
+
+// the main loop calls param_store_commit each pass, a byte burn is done befor the next pass
+static void run_commit(void)
+{
+    now += PARAM_COMMIT_SETTLE;
+    for (int pass = 0; pass < 2 * EE_PARAM_SLOT_SIZE; pass++)
+    {
+        ee_busy = 0;
+        param_store_commit();
+    }
+}
+
+// power up with the EEPROM as it was left
+static void power_up(void)
+{
+    power_left = POWER_ON;
+    ee_busy = 0;
+    param_store_load();
+}
+
+int main(void)
+{
+    unsigned long bad = 0;
+    srand(1);
+    printf("PARAM_IMAGE_t is %u bytes, a slot is %u\n", (unsigned) sizeof(PARAM_IMAGE_t), (unsigned) EE_PARAM_SLOT_SIZE);
+
+    // a blank journal takes the legacy values and commits them
+    memset(ee, 0xFF, sizeof(ee));
+    power_up();
+    if (param_source != PARAM_SOURCE_LEGACY)
+    {
+        printf("blank journal: source %d\n", param_source);
+        ++bad;
+    }
+    run_commit();
+    power_up();
+    if (param_source != PARAM_SOURCE_JOURNAL)
+    {
+        printf("first commit: source %d\n", param_source);
+        ++bad;
+    }
+
+    // commit a change, a quarter of them have the power cut at a random byte, then power up again
+    PARAM_IMAGE_t committed = param;
+    unsigned long cuts = 0;
+    for (unsigned long round = 0; round < 20000; round++)
+    {
+        param.bat_high_limit = (uint16_t) rand();
+        param.shutdown_ttl_limit = (uint32_t) rand();
+        param_stage(PARAM_BAT_HIGH);
+        PARAM_IMAGE_t staged = param;
+        staged.sequence++;
+        int cut = ((rand() % 4) == 0);
+        if (cut) ++cuts;
+        power_left = cut ? 1 + (rand() % sizeof(PARAM_IMAGE_t)) : POWER_ON;
+        run_commit();
+        power_up();
+        if (param_source != PARAM_SOURCE_JOURNAL)
+        {
+            if (bad < 5) printf("round %lu: source %d\n", round, param_source);
+            ++bad;
+            continue;
+        }
+        // the crc is only set by a commit, so compare the rest
+        int is_staged = !memcmp(&param, &staged, offsetof(PARAM_IMAGE_t, crc));
+        int is_committed = !memcmp(&param, &committed, offsetof(PARAM_IMAGE_t, crc));
+        if ( (!cut && !is_staged) || (cut && !is_staged && !is_committed) )
+        {
+            if (bad < 5) printf("round %lu: cut %d loaded sequence %u, staged %u, committed %u\n", round, cut, 
+                param.sequence, staged.sequence, committed.sequence);
+            ++bad;
+        }
+        committed = param;
+    }
+    printf("%lu commits, %lu cut short: %lu bad loads\n", 20000UL, cuts, bad);
+
+    // a journal that is not blank with no good slot uses the defaults
+    for (uint8_t slot = 0; slot < EE_PARAM_SLOTS; slot++)
+    {
+        ee[EE_PARAM_JOURNAL_ADDR + (EE_PARAM_SLOT_SIZE * slot) + offsetof(PARAM_IMAGE_t, bat_high_limit)] ^= 0x55;
+    }
+    power_up();
+    if ( (param_source != PARAM_SOURCE_DEFAULT) || (param.reference[REFERENCE_EXTERN_AVCC] != (float) 5.0) )
+    {
+        printf("no good slot: source %d\n", param_source);
+        ++bad;
+    }
+
+    printf("%s\n", bad ? "FAIL" : "PASS");
+    return bad ? 1 : 0;
+}
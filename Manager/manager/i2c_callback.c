@@ -32,7 +32,9 @@ SOFTWARE.
 
 #include <stdio.h>
 #include <string.h>
+#include "../lib/timers_bsd.h"
 #include "../lib/twi0_bsd.h"
+#include "../lib/twi0_queue_bsd.h"
 #include "../lib/io_enum_bsd.h"
 #include "i2c_callback.h"
 
@@ -45,71 +47,275 @@ SOFTWARE.
 // 7 .. prevent sending bad data
 uint8_t twi_errorCode;
 
-// largest I2C transaction with manager so far is six bytes.
-#define MAX_CMD_SIZE 8
-
-uint8_t i2c_is_in_use; // wait for the resource to be free befor loading buffers
-uint8_t i2c_address_;
-uint8_t txBuffer_[MAX_CMD_SIZE];
-uint8_t bytes_to_write_; // master wrties bytes to slave (you may want to zero the last byte txBuffer array)
-uint8_t rxBuffer_[MAX_CMD_SIZE];
-uint8_t bytes_to_read_; // master reads bytes from slave (you may want to zero the rxBuffer array)
-uint8_t i2c_address_; // master address this slave
-
 // command is used to send a byte from manager
 #define ADDRESS_CMD {0x01,0x00}
 #define ADDRESS_CMD_SIZE 2
 
+// events wait here until the application has them
+typedef struct {
+    uint8_t address; // callback address
+    uint8_t route;
+    uint8_t data;
+    uint8_t state; // EVENT_WAITING, EVENT_IN_FLIGHT, or EVENT_TAKEN
+    unsigned long at; // milliseconds() when the event happened
+} CALLBACK_EVENT_t;
+
+#define EVENT_WAITING 0
+#define EVENT_IN_FLIGHT 1
+#define EVENT_TAKEN 2
+
+static CALLBACK_EVENT_t event[EVENT_BUFFER_SIZE];
+static uint8_t event_head; // oldest event
+static uint8_t event_count;
+static uint8_t event_in_flight; // events in the message being sent
+static uint8_t event_in_flight_address;
+static unsigned long event_retry_at;
+static uint8_t event_retry;
+static uint8_t event_attempts; // messages to event_in_flight_address that were not ACKed in a row
+static uint8_t event_pull_only[EVENT_PULL_ONLY_MAX]; // addresses that did not ACK EVENT_ATTEMPTS_MAX times, zero is none
+uint8_t event_batch_route; // CB_ROUTE_EVENTS_OFF sends each event as its own callback
+uint8_t event_lost;
+
+static CALLBACK_EVENT_t *event_at(uint8_t index)
+{
+    uint8_t i = event_head + index;
+    if (i >= EVENT_BUFFER_SIZE) i -= EVENT_BUFFER_SIZE;
+    return &event[i];
+}
+
+// remove the events that were taken (sent or pulled), the others keep their order
+static void event_remove_taken(void)
+{
+    uint8_t kept = 0;
+    for (uint8_t i = 0; i < event_count; i++)
+    {
+        CALLBACK_EVENT_t *evnt = event_at(i);
+        if (evnt->state == EVENT_TAKEN) continue;
+        if (kept != i) *event_at(kept) = *evnt;
+        kept++;
+    }
+    event_count = kept;
+}
+
+static uint8_t event_is_pull_only(uint8_t address)
+{
+    for (uint8_t i = 0; i < EVENT_PULL_ONLY_MAX; i++)
+    {
+        if (event_pull_only[i] == address) return 1;
+    }
+    return 0;
+}
+
+static void event_set_pull_only(uint8_t address)
+{
+    for (uint8_t i = 0; i < EVENT_PULL_ONLY_MAX; i++)
+    {
+        if (!event_pull_only[i])
+        {
+            event_pull_only[i] = address;
+            return;
+        }
+    }
+    event_pull_only[EVENT_PULL_ONLY_MAX - 1] = address; // more addresses than slots, the last one is replaced
+}
+
+// an application registered (cmd 19 or cmd 23 route write), so callbacks are sent to every address again
+void i2c_callback_registered(void)
+{
+    for (uint8_t i = 0; i < EVENT_PULL_ONLY_MAX; i++)
+    {
+        event_pull_only[i] = 0;
+    }
+    event_attempts = 0;
+    event_retry = 0;
+}
+
+// big endian age (mSec) of an event
+static uint8_t *event_pack(uint8_t *buf, CALLBACK_EVENT_t *evnt)
+{
+    unsigned long age = milliseconds() - evnt->at;
+    buf[0] = evnt->route;
+    buf[1] = evnt->data;
+    buf[2] = ( (0xFF000000 & age) >>24 ); 
+    buf[3] = ( (0x00FF0000 & age) >>16 ); 
+    buf[4] = ( (0x0000FF00 & age) >>8 ); 
+    buf[5] = ( (0x000000FF & age) ); 
+    return buf + EVENT_PACKED_SIZE;
+}
 
 // command is used to send a byte from manager to application
 // i2c_address is the slave address for callback to place the data
 // command allows the slave address to be used for multiple data (e.g., events or state machine values)
-void i2c_callback(uint8_t i2c_address, uint8_t command, uint8_t data, TWI0_LOOP_STATE_t *loop_state)
+// The event is buffered so the state machine does not wait for the bus, and kept until the application has it.
+// An event that repeats the last one waiting is coalesced with it, when the buffer is full the oldest event is lost.
+uint8_t i2c_callback(uint8_t i2c_address, uint8_t command, uint8_t data)
 { 
-    // if not in INTI state ignore 
-    if ( (*loop_state == TWI0_LOOP_STATE_INIT) )
-    {
-        i2c_is_in_use = 1; // flag for other (state machine) to see that it is in use 
-        i2c_address_ = i2c_address;
-        bytes_to_write_ = ADDRESS_CMD_SIZE;
-        txBuffer_[0] = command; // replace the command byte
-        txBuffer_[1] = data; // replace the select byte
-        txBuffer_[2] = 0;
-        bytes_to_read_ = ADDRESS_CMD_SIZE;
-        rxBuffer_[0] = 0;
-        rxBuffer_[1] = 0;
-        rxBuffer_[2] = 0;
-        ioWrite(MCU_IO_MGR_SCK_LED, LOGIC_LEVEL_LOW); // LED ON
-        *loop_state = TWI0_LOOP_STATE_ASYNC_WRT; // set write state
+    if (event_count)
+    {
+        CALLBACK_EVENT_t *last = event_at(event_count - 1);
+        if ( (last->state == EVENT_WAITING) && (last->address == i2c_address) && (last->route == command) && (last->data == data) ) return 1;
     }
-}
-
-// wait for TWI to finish
-uint8_t i2c_callback_waiting(TWI0_LOOP_STATE_t *loop_state)
-{ 
-    uint8_t done = 1; 
-    if (*loop_state > TWI0_LOOP_STATE_INIT)
+    if (event_count >= EVENT_BUFFER_SIZE)
     {
-        uint8_t bytes_read = twi0_masterWriteRead(i2c_address_, txBuffer_, bytes_to_write_, rxBuffer_, bytes_to_read_, loop_state);
-        if( (*loop_state == TWI0_LOOP_STATE_DONE) )
+        // lose the oldest event that is not being sent, there are more events than a message holds
+        for (uint8_t i = 0; i < event_count; i++)
         {
-            // twi0_masterWriteRead error code is in bits 5..7
-            if(bytes_read & 0xE0)
+            CALLBACK_EVENT_t *oldest = event_at(i);
+            if (oldest->state == EVENT_WAITING)
             {
-                twi_errorCode = bytes_read>>5;
+                oldest->state = EVENT_TAKEN;
+                break;
             }
-            ioWrite(MCU_IO_MGR_SCK_LED, LOGIC_LEVEL_HIGH); // LED OFF
-            *loop_state = TWI0_LOOP_STATE_RAW;
-            i2c_is_in_use = 0;
-            done = 0;
         }
+        event_remove_taken();
+        if (event_lost < 255) event_lost++;
+    }
+    CALLBACK_EVENT_t *evnt = event_at(event_count);
+    evnt->address = i2c_address;
+    evnt->route = command;
+    evnt->data = data;
+    evnt->state = EVENT_WAITING;
+    evnt->at = milliseconds();
+    event_count++;
+    return 1;
+}
+
+// events waiting for the application
+uint8_t i2c_callback_events(void)
+{
+    return event_count;
+}
+
+// I2C command 23 lets the application pull events (e.g., after it was reset or busy, or its address stopped taking callbacks), 
+// pulled events are removed, returns the number of events placed in buf (EVENT_PACKED_SIZE bytes each)
+uint8_t i2c_callback_pull(uint8_t *buf, uint8_t max_events)
+{
+    uint8_t count = 0;
+    for (uint8_t i = 0; (i < event_count) && (count < max_events); i++)
+    {
+        CALLBACK_EVENT_t *evnt = event_at(i);
+        if (evnt->state != EVENT_WAITING) continue; // being sent
+        buf = event_pack(buf, evnt);
+        evnt->state = EVENT_TAKEN;
+        count++;
+    }
+    event_remove_taken();
+    return count;
+}
+
+// the message with the events in flight is done, status is zero if it was ACKed
+static void event_done(uint8_t status)
+{
+    uint8_t next_state = status ? EVENT_WAITING : EVENT_TAKEN;
+    for (uint8_t i = 0; i < event_count; i++)
+    {
+        CALLBACK_EVENT_t *evnt = event_at(i);
+        if (evnt->state == EVENT_IN_FLIGHT) evnt->state = next_state;
+    }
+    event_in_flight = 0;
+    if (!status)
+    {
+        event_remove_taken();
+        event_attempts = 0;
+        return;
+    }
+    if (++event_attempts >= EVENT_ATTEMPTS_MAX)
+    {
+        // the application is gone (or has no slave handler), its events wait to be pulled so others are not held up
+        event_set_pull_only(event_in_flight_address);
+        event_attempts = 0;
+        return;
+    }
+    event_retry = 1;
+    event_retry_at = milliseconds();
+}
+
+// send events, a batch route sends up to EVENT_BATCH_MAX events (with the same address) in one message.
+// A message that fails (e.g., the application is resetting) is sent again after EVENT_RETRY_MSEC, after EVENT_ATTEMPTS_MAX 
+// tries the address is pull only (cmd 23) until an application registers, and events for other addresses are sent.
+static void event_send(void)
+{
+    if (event_in_flight)
+    {
+        if (twi0_queue_depth()) return; // still sending
+        event_done(twi0_queue_status());
+    }
+    if (event_retry)
+    {
+        if (elapsed(&event_retry_at) < EVENT_RETRY_MSEC) return;
+        event_retry = 0;
+    }
+
+    // oldest event for an address that takes callbacks
+    CALLBACK_EVENT_t *evnt = 0;
+    uint8_t index;
+    for (index = 0; index < event_count; index++)
+    {
+        CALLBACK_EVENT_t *next = event_at(index);
+        if ( (next->state == EVENT_WAITING) && !event_is_pull_only(next->address) )
+        {
+            evnt = next;
+            break;
+        }
+    }
+    if (!evnt) return;
+    if (evnt->address != event_in_flight_address)
+    {
+        event_attempts = 0;
+        event_in_flight_address = evnt->address;
+    }
+
+    uint8_t txBuffer[TWI0_QUEUE_MSG_SIZE];
+    uint8_t length;
+    if (event_batch_route == CB_ROUTE_EVENTS_OFF)
+    {
+        txBuffer[0] = evnt->route; // replace the command byte
+        txBuffer[1] = evnt->data; // replace the select byte
+        length = ADDRESS_CMD_SIZE;
+        evnt->state = EVENT_IN_FLIGHT;
+        event_in_flight = 1;
+    }
+    else
+    {
+        uint8_t *buf = &txBuffer[2];
+        txBuffer[0] = event_batch_route;
+        for ( ; (index < event_count) && (event_in_flight < EVENT_BATCH_MAX); index++)
+        {
+            CALLBACK_EVENT_t *next = event_at(index);
+            if ( (next->state != EVENT_WAITING) || (next->address != evnt->address) ) continue;
+            buf = event_pack(buf, next);
+            next->state = EVENT_IN_FLIGHT;
+            event_in_flight++;
+        }
+        txBuffer[1] = event_in_flight;
+        length = buf - txBuffer;
     }
-    else // this should not be called with INIT or DONE state, but just in case make the state RAW.
+    if ( !twi0_queue_post(evnt->address, txBuffer, length) )
     {
-        *loop_state = TWI0_LOOP_STATE_RAW;
-        done = 0;
-        // do not clear the i2c_is_in_use flag.
+        for (index = 0; index < event_count; index++)
+        {
+            CALLBACK_EVENT_t *next = event_at(index);
+            if (next->state == EVENT_IN_FLIGHT) next->state = EVENT_WAITING; // try again next time
+        }
+        event_in_flight = 0;
     }
-    
-    return done;
-}
\ No newline at end of file
+}
+
+// send buffered callbacks, the LED is on while a callback is being sent (it is also used for blinking so only change it on an edge)
+void i2c_callback_pump(void)
+{ 
+    static uint8_t led_on;
+    event_send();
+    uint8_t sending = twi0_queue_pump();
+    if (sending && !led_on)
+    {
+        ioWrite(MCU_IO_MGR_SCK_LED, LOGIC_LEVEL_LOW); // LED ON
+        led_on = 1;
+    }
+    else if (!sending && led_on)
+    {
+        ioWrite(MCU_IO_MGR_SCK_LED, LOGIC_LEVEL_HIGH); // LED OFF
+        led_on = 0;
+    }
+    twi_errorCode = twi0_queue_error();
+}
@@ -3,10 +3,24 @@
 
 #include "../lib/twi0_bsd.h"
 
+// events buffered for the application, a batch has up to EVENT_BATCH_MAX events
+// batch message: byte[0] = event_batch_route, byte[1] = events, then for each event route, data, and age (mSec, four bytes big endian)
+#define EVENT_BUFFER_SIZE 12
+#define EVENT_PACKED_SIZE 6
+#define EVENT_BATCH_MAX 4
+#define EVENT_RETRY_MSEC 1000UL
+#define EVENT_ATTEMPTS_MAX 3
+#define EVENT_PULL_ONLY_MAX 3
+#define CB_ROUTE_EVENTS_OFF 0
+
 extern uint8_t twi_errorCode;
-extern uint8_t i2c_is_in_use;
+extern uint8_t event_batch_route;
+extern uint8_t event_lost;
 
-extern void i2c_callback(uint8_t i2c_address, uint8_t command, uint8_t data,TWI0_LOOP_STATE_t *loop_state);
-uint8_t i2c_callback_waiting(TWI0_LOOP_STATE_t *loop_state);
+extern uint8_t i2c_callback(uint8_t i2c_address, uint8_t command, uint8_t data);
+extern uint8_t i2c_callback_events(void);
+extern uint8_t i2c_callback_pull(uint8_t *buf, uint8_t max_events);
+extern void i2c_callback_registered(void);
+extern void i2c_callback_pump(void);
 
 #endif // I2C_Callback_h
@@ -33,11 +33,15 @@ SOFTWARE.
 #include <stdbool.h>
 #include <string.h>
 #include <avr/io.h>
+#include <util/atomic.h>
 #include "../lib/timers_bsd.h"
 #include "../lib/twi0_bsd.h"
+#include "../lib/twi0_queue_bsd.h"
 #include "../lib/uart0_bsd.h"
 #include "../lib/adc_bsd.h"
 #include "../lib/io_enum_bsd.h"
+#include "../lib/sched_bsd.h"
+#include "../lib/idle_bsd.h"
 #include "main.h"
 #include "rpubus_manager_state.h"
 #include "dtr_transmition.h"
@@ -51,21 +55,29 @@ SOFTWARE.
 #include "host_shutdown_manager.h"
 #include "host_shutdown_limits.h"
 #include "calibration_limits.h"
+#include "i2c_callback.h"
+#include "scan_time.h"
+#include "param_store.h"
+#include "energy_counters.h"
 
 uint8_t i2c0Buffer[I2C_BUFFER_LENGTH];
 uint8_t i2c0BufferLength = 0;
 
+uint8_t i2c0_overrun; // writes held (SCL low) since the last command was not handled yet
+unsigned long i2c0_stretch_max; // longest time (mSec) SCL was held low waiting for a reply
+static volatile uint8_t i2c0_has_numBytes_to_handle;
+static unsigned long i2c0_stretch_started_at;
+
 // called when I2C data is received. 
+// The command is run by handle_i2c0_receive in the main loop, so the ISR only copies the bytes.
+// A write that starts befor that is held on its address (SCL low) until handle_i2c0_receive releases it, 
+// so it is never ACKed and then dropped.
 void receive_i2c_event(uint8_t* inBytes, uint8_t numBytes) 
 {
-    // table of pointers to functions that are selected by the i2c cmmand byte
-    static void (*pf[GROUP][MGR_CMDS])(uint8_t*) = 
+    if (i2c0_has_numBytes_to_handle)
     {
-        {fnMgrAddr, fnStatus, fnBootldAddr, fnArduinMode, fnHostShutdwnMgr, fnHostShutdwnIntAccess, fnHostShutdwnULAccess, fnNull},
-        {fnBatteryMgr, fnBatteryIntAccess, fnBatteryULAccess, fnDayNightMgr, fnDayNightIntAccess, fnDayNightULAccess, fnNull, fnNull},
-        {fnAnalogRead, fnCalibrationRead, fnNull, fnNull, fnRdTimedAccum, fnNull, fnReferance, fnNull},
-        {fnStartTestMode, fnEndTestMode, fnRdXcvrCntlInTestMode, fnWtXcvrCntlInTestMode, fnNull, fnNull, fnNull, fnNull}
-    };
+        return; // not expected since twi0_slaveRxDefer holds the write, i2c0Buffer is in use by the main loop
+    }
 
     // i2c will echo's back what was sent (plus modifications) with transmit event
     uint8_t i;
@@ -75,6 +87,40 @@ void receive_i2c_event(uint8_t* inBytes, uint8_t numBytes)
     }
     if(i < I2C_BUFFER_LENGTH) i2c0Buffer[i+1] = 0; // room for null
     i2c0BufferLength = numBytes;
+    i2c0_has_numBytes_to_handle = 1;
+    twi0_slaveRxDefer();
+    sched_event(SCHED_EVENT_TWI0);
+}
+
+// called when the I2C master wants the reply
+void transmit_i2c_event(void) 
+{
+    if (i2c0_has_numBytes_to_handle)
+    {
+        // hold SCL low until the main loop has run the command
+        i2c0_stretch_started_at = milliseconds();
+        twi0_slaveTxDefer();
+        return;
+    }
+
+    // respond with an echo of the last message sent
+    uint8_t return_code = twi0_fillSlaveTxBuffer(i2c0Buffer, i2c0BufferLength);
+    if (return_code != 0)
+        status_byt |= (1<<DTR_I2C_TRANSMIT_FAIL);
+}
+
+// run the I2C command function from the main loop (like handle_smbus_receive), the reply is the modified i2c0Buffer.
+static void run_i2c_command(void)
+{
+    // table of pointers to functions that are selected by the i2c cmmand byte
+    static void (*pf[GROUP][MGR_CMDS])(uint8_t*) = 
+    {
+        {fnMgrAddr, fnStatus, fnBootldAddr, fnArduinMode, fnHostShutdwnMgr, fnHostShutdwnIntAccess, fnHostShutdwnULAccess, fnMultiDropMpcm},
+        {fnBatteryMgr, fnBatteryIntAccess, fnBatteryULAccess, fnDayNightMgr, fnDayNightIntAccess, fnDayNightULAccess, fnSnapshot, fnEvents},
+        {fnAnalogRead, fnCalibrationRead, fnAnalogStats, fnEnergy, fnRdTimedAccum, fnNull, fnReferance, fnNull},
+        {fnStartTestMode, fnEndTestMode, fnRdXcvrCntlInTestMode, fnWtXcvrCntlInTestMode, fnNull, fnNull, fnNull, fnNull},
+        {fnScanTime, fnScanTimeReset, fnBootTime, fnIsrToLoop, fnNull, fnNull, fnNull, fnNull}
+    };
 
     // my i2c commands size themselfs with data, so at least two bytes (e.g., cmd + one_data_byte)
     if(i2c0BufferLength <= 1) 
@@ -106,12 +152,31 @@ void receive_i2c_event(uint8_t* inBytes, uint8_t numBytes)
     return;	
 }
 
-void transmit_i2c_event(void) 
+// main loop runs the command received by the ISR, and if the master is already waiting (SCL held low) sends the reply,
+// or lets in the write that was held (the previous reply is then not read).
+void handle_i2c0_receive(void)
 {
-    // respond with an echo of the last message sent
-    uint8_t return_code = twi0_fillSlaveTxBuffer(i2c0Buffer, i2c0BufferLength);
-    if (return_code != 0)
-        status_byt |= (1<<DTR_I2C_TRANSMIT_FAIL);
+    if (i2c0_has_numBytes_to_handle)
+    {
+        run_i2c_command();
+        ATOMIC_BLOCK ( ATOMIC_RESTORESTATE )
+        {
+            i2c0_has_numBytes_to_handle = 0;
+            if (twi0_slaveTxIsDeferred())
+            {
+                uint8_t return_code = twi0_fillSlaveTxBuffer(i2c0Buffer, i2c0BufferLength);
+                if (return_code != 0)
+                    status_byt |= (1<<DTR_I2C_TRANSMIT_FAIL);
+                twi0_slaveTxRelease();
+                unsigned long stretch = elapsed(&i2c0_stretch_started_at);
+                if (stretch > i2c0_stretch_max) i2c0_stretch_max = stretch;
+            }
+            if (twi0_slaveRxRelease())
+            {
+                if (i2c0_overrun < 255) i2c0_overrun++;
+            }
+        }
+    }
 }
 
 /********* MULTI-POINT MODE ***********
@@ -361,21 +426,21 @@ void fnHostShutdwnULAccess(uint8_t* i2cBuffer)
         switch (offset)
         {
         case 0:
-            if (WriteEEShtDwnHaltTTL(&new_value))
+            if (IsValidShtDwnHaltTTL(&new_value))
             {
                 shutdown_ttl_limit = new_value;
                 shutdown_limit_loaded = HOSTSHUTDOWN_LIM_HALT_TTL_TOSAVE; // main loop will save to eeprom
             } 
             break;
         case 1:
-            if (WriteEEShtDwnDelay(&new_value))
+            if (IsValidShtDwnDelay(&new_value))
             {
                 shutdown_delay_limit = new_value;
                 shutdown_limit_loaded = HOSTSHUTDOWN_LIM_DELAY_TOSAVE; // main loop will save to eeprom
             } 
             break;
         case 2:
-            if (WriteEEShtDwnWearleveling(&new_value))
+            if (IsValidShtDwnWearleveling(&new_value))
             {
                 shutdown_wearleveling_limit = new_value;
                 shutdown_limit_loaded = HOSTSHUTDOWN_LIM_WEARLEVELING_TOSAVE; // main loop will save to eeprom
@@ -388,6 +453,23 @@ void fnHostShutdwnULAccess(uint8_t* i2cBuffer)
     }
 }
 
+// I2C command to access the multi-drop framing (rpu_mpcm) the application controller should use.
+// The host and all the nodes on a bus need to use the same framing, so it is kept in the manager and saved in EEPROM.
+// The application reads it (with its address) during setup, a change needs an application reset.
+// I2C: byte[0] = 7, 
+//      byte[1] = bit 7 clear is read/bit 7 set is write, 
+//                bit 0 is RPU_MPCM_OFF [0] or RPU_MPCM_ON [1] (9 bit address frame before each command line).
+void fnMultiDropMpcm(uint8_t* i2cBuffer)
+{
+    uint8_t tmp_mpcm = i2cBuffer[1];
+    i2cBuffer[1] = rpu_mpcm;
+    if (tmp_mpcm & 0x80) 
+    {
+        rpu_mpcm = tmp_mpcm & 0x01;
+        write_rpu_address_to_eeprom = 1; // saves the ID, rpu_address, and rpu_mpcm
+    }
+}
+
 /********* PV and Battery Management ***********/
 
 // I2C command to enable battery manager and set a i2c callback address for bm_state when command command byte is > zero.
@@ -540,6 +622,9 @@ void fnDayNightMgr(uint8_t* i2cBuffer)
     day_work_callback_route = i2cBuffer[3];
     night_work_callback_route = i2cBuffer[4];
     daynight_callback_poke = 1; // don't poke me... oh you must have reset.
+    // an application registers with this first (see PVandBattery.md cmd 23), it may not know batches so it sets the batch route after this if it does
+    event_batch_route = CB_ROUTE_EVENTS_OFF;
+    i2c_callback_registered();
 }
 
 // I2C command to access daynight manager uint16 values.
@@ -696,6 +781,115 @@ void fnDayNightULAccess(uint8_t* i2cBuffer)
 }
 
 
+// place a big endian uint16 or uint32 in the I2C buffer for a snapshot
+static uint8_t *snapshot_u16(uint8_t *buf, uint16_t value)
+{
+    buf[0] = ( (0xFF00 & value) >>8 );
+    buf[1] = ( (0x00FF & value) );
+    return buf + 2;
+}
+
+static uint8_t *snapshot_u32(uint8_t *buf, uint32_t value)
+{
+    buf = snapshot_u16(buf, (uint16_t) (value >>16));
+    return snapshot_u16(buf, (uint16_t) value);
+}
+
+// I2C command to read a packed snapshot of a subsystem in one transaction (in place of a command for each value).
+// Values are big endian like the other commands, the master sends as many bytes as it wants returned (up to SNAPSHOT_*_SIZE).
+// I2C: byte[0] = 22, 
+//      byte[1] = SNAPSHOT_DAYNIGHT [0], SNAPSHOT_SHUTDOWN [1], SNAPSHOT_ANALOG [2], SNAPSHOT_TWI [3], or SNAPSHOT_DECIMATED [4], 
+//                returned with SNAPSHOT_DONE (bit 7) set so an echo from fnNull is not taken as a snapshot, 0xFF is returned for others
+// SNAPSHOT_DAYNIGHT: byte[2] = daynight_state, byte[3..4] = morning_threshold, byte[5..6] = evening_threshold,
+//      byte[7..10] = morning_debounce, byte[11..14] = evening_debounce, byte[15..18] = elapsed daynight_timer, byte[19..20] = ALT_V adc
+// SNAPSHOT_SHUTDOWN: byte[2] = shutdown_state, byte[3..4] = halt_curr_limit, byte[5..6] = PWR_I adc,
+//      byte[7..10] = ttl_limit, byte[11..14] = delay_limit, byte[15..18] = wearleveling_limit, byte[19..22] = elapsed shutdown_kRuntime
+// SNAPSHOT_ANALOG: byte[2..9] = ALT_I, ALT_V, PWR_I, PWR_V adc, byte[10] = analog_generation
+// SNAPSHOT_TWI: byte[2] = callback queue depth, byte[3] = queue high water, byte[4] = callbacks dropped, byte[5] = last callback twi error,
+//      byte[6] = i2c0_overrun (writes held), byte[7..10] = i2c0_stretch_max, byte[11] = events waiting, byte[12] = events lost
+// SNAPSHOT_DECIMATED: byte[2] = adc_oversample_bits, byte[3] = adc_burst_count (sequence), 
+//      byte[4..11] = ALT_I, ALT_V, PWR_I, PWR_V with 10 + adc_oversample_bits of resolution
+void fnSnapshot(uint8_t* i2cBuffer)
+{
+    uint8_t *buf = &i2cBuffer[2];
+    switch (i2cBuffer[1])
+    {
+    case SNAPSHOT_DAYNIGHT:
+        *buf++ = (uint8_t) daynight_state;
+        buf = snapshot_u16(buf, (uint16_t) daynight_morning_threshold);
+        buf = snapshot_u16(buf, (uint16_t) daynight_evening_threshold);
+        buf = snapshot_u32(buf, daynight_morning_debounce);
+        buf = snapshot_u32(buf, daynight_evening_debounce);
+        buf = snapshot_u32(buf, elapsed(&daynight_timer));
+        snapshot_u16(buf, adcAtomic(ADC_CH_ALT_V));
+        break;
+    case SNAPSHOT_SHUTDOWN:
+        *buf++ = (uint8_t) shutdown_state;
+        buf = snapshot_u16(buf, (uint16_t) shutdown_halt_curr_limit);
+        buf = snapshot_u16(buf, adcAtomic(ADC_CH_PWR_I));
+        buf = snapshot_u32(buf, shutdown_ttl_limit);
+        buf = snapshot_u32(buf, shutdown_delay_limit);
+        buf = snapshot_u32(buf, shutdown_wearleveling_limit);
+        snapshot_u32(buf, elapsed(&shutdown_kRuntime));
+        break;
+    case SNAPSHOT_ANALOG:
+        for (uint8_t adc_enum = 0; adc_enum < ADC_ENUM_END; adc_enum++)
+        {
+            buf = snapshot_u16(buf, adcAtomic(adcMap[adc_enum].channel));
+        }
+        *buf = analog_generation;
+        break;
+    case SNAPSHOT_TWI:
+        *buf++ = twi0_queue_depth();
+        *buf++ = twi0_queue_high_water();
+        *buf++ = twi0_queue_drops();
+        *buf++ = twi0_queue_error();
+        *buf++ = i2c0_overrun;
+        buf = snapshot_u32(buf, i2c0_stretch_max);
+        *buf++ = i2c_callback_events();
+        *buf = event_lost;
+        break;
+    case SNAPSHOT_DECIMATED:
+        ATOMIC_BLOCK ( ATOMIC_RESTORESTATE )
+        {
+            // all four from the same burst
+            *buf++ = adc_oversample_bits;
+            *buf++ = adc_burst_count;
+            for (uint8_t adc_enum = 0; adc_enum < ADC_ENUM_END; adc_enum++)
+            {
+                buf = snapshot_u16(buf, adc_decimated[adcMap[adc_enum].channel]);
+            }
+        }
+        break;
+
+    default:
+        i2cBuffer[1] = 0xFF;
+        return;
+    }
+    i2cBuffer[1] |= SNAPSHOT_DONE;
+}
+
+// I2C command for the buffered events the manager sends to the application callback address
+// I2C: byte[0] = 23, 
+//      byte[1] = bit 7 set is write the batch route in bits 6..0 (CB_ROUTE_EVENTS_OFF [0] sends each event on its own route), the old route is returned,
+//                bit 7 clear is pull events, the number of events returned is placed here,
+//      byte[2] = pull up to this many events (EVENT_BATCH_MAX is the most), the events still waiting are returned here,
+//      byte[3..] = route, data, and age (mSec, four bytes) for each event pulled.
+void fnEvents(uint8_t* i2cBuffer)
+{
+    if (i2cBuffer[1] & 0x80)
+    {
+        uint8_t route = i2cBuffer[1] & 0x7F;
+        i2cBuffer[1] = event_batch_route;
+        event_batch_route = route;
+        i2c_callback_registered();
+        return;
+    }
+    uint8_t max_events = i2cBuffer[2];
+    if (max_events > EVENT_BATCH_MAX) max_events = EVENT_BATCH_MAX;
+    i2cBuffer[1] = i2c_callback_pull(&i2cBuffer[3], max_events);
+    i2cBuffer[2] = i2c_callback_events();
+}
 
 /********* Analog ***********
   *  ADC_ENUM_t has ADC_ENUM_ALT_I, ADC_ENUM_ALT_V, ADC_ENUM_PWR_I, ADC_ENUM_PWR_V, ADC_ENUM_END
@@ -706,6 +900,7 @@ void fnDayNightULAccess(uint8_t* i2cBuffer)
 // returns the adc value with high byte after command byte, then low byte next.
 // Most AVR have ten analog bits, thus range is: 0..1023
 // returns zero when given an invalid channel
+// if a fourth byte is sent it returns analog_generation, which changes when a reference or calibration has changed
 void fnAnalogRead(uint8_t* i2cBuffer)
 {
     uint16_t adc_enum = 0;
@@ -722,6 +917,54 @@ void fnAnalogRead(uint8_t* i2cBuffer)
     }
     i2cBuffer[1] = ( (0xFF00 & adc_reading) >>8 ); 
     i2cBuffer[2] = ( (0x00FF & adc_reading) ); 
+    i2cBuffer[3] = analog_generation; // seen if four bytes were sent
+}
+
+// I2C command to read the adc stats window for all four channels in one transaction (e.g., one SMBus block read)
+// I2C: byte[0] = 34, 
+//      byte[1] = ADC_STATS_RESET (bit 0) starts a new window after the read, returned as ADC_STATS_DONE (bit 7) + adc_oversample_bits 
+//      byte[2..3] = count (bursts in the window), 
+//      byte[4..27] = min, max, and mean for ALT_I, ALT_V, PWR_I, PWR_V with 10 + adc_oversample_bits of resolution
+void fnAnalogStats(uint8_t* i2cBuffer)
+{
+    uint8_t reset = i2cBuffer[1] & ADC_STATS_RESET;
+    uint8_t *buf = snapshot_u16(&i2cBuffer[2], adc_stats_count);
+    for (uint8_t adc_enum = 0; adc_enum < ADC_ENUM_END; adc_enum++)
+    {
+        ADC_STATS_t *stats = &adc_stats[adc_enum];
+        uint16_t mean = 0;
+        if (adc_stats_count) mean = (uint16_t) (stats->sum / adc_stats_count);
+        buf = snapshot_u16(buf, stats->min);
+        buf = snapshot_u16(buf, stats->max);
+        buf = snapshot_u16(buf, mean);
+    }
+    i2cBuffer[1] = ADC_STATS_DONE | adc_oversample_bits;
+    if (reset) adc_stats_reset();
+}
+
+// I2C command to read a set of charge and energy counters in one transaction (e.g., one SMBus block read)
+// I2C: byte[0] = 35, 
+//      byte[1] = ENERGY_SET_NOW [0], ENERGY_SET_AT_DAY [1], or ENERGY_SET_AT_NIGHT [2], 
+//                returned with ENERGY_DONE (bit 7) set, 0xFF is returned for others
+//      byte[2..7] = ALT uAh, byte[8..13] = ALT uWh, byte[14..19] = PWR uAh, byte[20..25] = PWR uWh (48 bits each)
+void fnEnergy(uint8_t* i2cBuffer)
+{
+    uint8_t set = i2cBuffer[1];
+    if (set >= ENERGY_SETS)
+    {
+        i2cBuffer[1] = 0xFF;
+        return;
+    }
+    uint8_t *buf = &i2cBuffer[2];
+    for (uint8_t input = 0; input < ENERGY_INPUTS; input++)
+    {
+        ENERGY_COUNTER_t *counter = &energy_counter[set][input];
+        buf = snapshot_u16(buf, (uint16_t) (counter->charge_uAh >>32));
+        buf = snapshot_u32(buf, (uint32_t) counter->charge_uAh);
+        buf = snapshot_u16(buf, (uint16_t) (counter->energy_uWh >>32));
+        buf = snapshot_u32(buf, (uint32_t) counter->energy_uWh);
+    }
+    i2cBuffer[1] = set | ENERGY_DONE;
 }
 
 // I2C command for Calibration of ADC_CH_ALT_I, ADC_CH_ALT_V, ADC_CH_PWR_I, ADC_CH_PWR_V adc channels
@@ -787,7 +1030,7 @@ void fnRdTimedAccum(uint8_t* i2cBuffer)
     adc_enum += ((uint32_t)i2cBuffer[2])<<16;
     adc_enum += ((uint32_t)i2cBuffer[3])<<8;
     adc_enum += ((uint32_t)i2cBuffer[4]);
-    unsigned long my_copy; //I2C runs this in ISR but durring SMBus this is not run in ISR context
+    unsigned long my_copy; //I2C and SMBus run this from the main loop (not in ISR context)
     if (adc_enum == ADC_ENUM_ALT_I)
     {
         my_copy = accumulate_alt_mega_ti;
@@ -962,6 +1205,85 @@ void fnWtXcvrCntlInTestMode(uint8_t* i2cBuffer)
     }
 }
 
+/********* SCAN TIME ***********
+  *  how long each main loop task takes, in Timer0 counts (64 crystal counts)
+  * */
+
+// I2C command to read the scan time of a task, the master sends SCAN_TIME_SIZE bytes to get all of it.
+// I2C: byte[0] = 64, 
+//      byte[1] = SCAN_TASK_t [0..SCAN_TASK_LOOP], returned with SCAN_TIME_DONE (bit 7) set, 0xFF is returned for others
+//      byte[2..3] = min, byte[4..5] = max, byte[6..7] = mean, byte[8..9] = count, byte[10..17] = histogram bins,
+//      byte[18] = scheduler overrun count (SCAN_TASK_IDLE and SCAN_TASK_LOOP are zero)
+void fnScanTime(uint8_t* i2cBuffer)
+{
+    uint8_t task = i2cBuffer[1];
+    if (task >= SCAN_TASK_END)
+    {
+        i2cBuffer[1] = 0xFF;
+        return;
+    }
+    SCAN_TIME_t *st = &scan_time[task];
+    uint16_t mean = 0;
+    if (st->count) mean = (uint16_t) (st->sum / st->count);
+    uint8_t *buf = &i2cBuffer[2];
+    buf = snapshot_u16(buf, st->min);
+    buf = snapshot_u16(buf, st->max);
+    buf = snapshot_u16(buf, mean);
+    buf = snapshot_u16(buf, st->count);
+    for (uint8_t i = 0; i < SCAN_TIME_BINS; i++)
+    {
+        buf = snapshot_u16(buf, st->bin[i]);
+    }
+    *buf = sched_overrun(task);
+    i2cBuffer[1] = task | SCAN_TIME_DONE;
+}
+
+// I2C command to clear the scan times and the idle wake counts, byte[1] returns the number of tasks (SCAN_TASK_END) 
+void fnScanTimeReset(uint8_t* i2cBuffer)
+{
+    scan_time_reset();
+    idle_reset();
+    i2cBuffer[1] = SCAN_TASK_END;
+}
+
+// I2C command to read how long the manager took to start, the master sends BOOT_TIME_SIZE bytes to get all of it.
+// I2C: byte[0] = 66, 
+//      byte[1] = where the settings came from (PARAM_SOURCE_t: journal, legacy, or default)
+//      byte[2..5] = boot_usec, byte[6..9] = config_load_usec, byte[10..11] = journal sequence
+void fnBootTime(uint8_t* i2cBuffer)
+{
+    uint8_t *buf = &i2cBuffer[2];
+    buf = snapshot_u32(buf, boot_usec);
+    buf = snapshot_u32(buf, config_load_usec);
+    snapshot_u16(buf, param.sequence);
+    i2cBuffer[1] = param_source;
+}
+
+// I2C command to read how often an ISR woke the manager from idle sleep and how long until the main loop ran, the master sends ISR_TO_LOOP_SIZE bytes to get all of it.
+// I2C: byte[0] = 67, 
+//      byte[1] = WAKE_t [0..WAKE_OTHER], returned with ISR_TO_LOOP_DONE (bit 7) set, 0xFF is returned for others
+//      byte[2..3] = count, byte[4..5] = last ISR to loop time, byte[6..7] = max ISR to loop time (uSec from the ISR start to the main loop)
+//      byte[8..9] = last wake latency, byte[10..11] = max wake latency (crystal counts from the interrupt to the ISR, WAKE_LATENCY_BOUND 
+//                   from the datasheet for the manager sources, none of them have a capture time)
+void fnIsrToLoop(uint8_t* i2cBuffer)
+{
+    uint8_t source = i2cBuffer[1];
+    if (source >= WAKE_SOURCES)
+    {
+        i2cBuffer[1] = 0xFF;
+        return;
+    }
+    IDLE_WAKE_t wake;
+    idle_wake( (WAKE_t) source, &wake);
+    uint8_t *buf = &i2cBuffer[2];
+    buf = snapshot_u16(buf, wake.count);
+    buf = snapshot_u16(buf, WAKE_COUNTS_TO_USEC(wake.last));
+    buf = snapshot_u16(buf, WAKE_COUNTS_TO_USEC(wake.max));
+    buf = snapshot_u16(buf, wake.latency_last);
+    snapshot_u16(buf, wake.latency_max);
+    i2cBuffer[1] = source | ISR_TO_LOOP_DONE;
+}
+
 /* Dummy function */
 void fnNull(uint8_t* i2cBuffer)
 {
@@ -3,14 +3,50 @@
 
 #define I2C_BUFFER_LENGTH 32
 
-#define GROUP  4
+#define GROUP  5
 #define MGR_CMDS  8
 
+// fnSnapshot subsystems and the number of bytes to send (and read) for all of the subsystem
+#define SNAPSHOT_DAYNIGHT 0
+#define SNAPSHOT_DAYNIGHT_SIZE 21
+#define SNAPSHOT_SHUTDOWN 1
+#define SNAPSHOT_SHUTDOWN_SIZE 23
+#define SNAPSHOT_ANALOG 2
+#define SNAPSHOT_ANALOG_SIZE 11
+#define SNAPSHOT_TWI 3
+#define SNAPSHOT_TWI_SIZE 13
+#define SNAPSHOT_DECIMATED 4
+#define SNAPSHOT_DECIMATED_SIZE 12
+
+// fnAnalogStats bytes to send (and read) for all four channels
+#define ADC_STATS_SIZE 28
+#define ADC_STATS_RESET 0x01
+#define ADC_STATS_DONE 0x80
+
+// fnEnergy bytes to send (and read) for a set of counters
+#define ENERGY_SIZE 26
+#define ENERGY_DONE 0x80
+#define SNAPSHOT_DONE 0x80
+
+// fnScanTime bytes to send (and read) for all of a task
+#define SCAN_TIME_SIZE 19
+#define SCAN_TIME_DONE 0x80
+
+// fnBootTime bytes to send (and read)
+#define BOOT_TIME_SIZE 12
+
+// fnIsrToLoop bytes to send (and read) for a wake source
+#define ISR_TO_LOOP_SIZE 12
+#define ISR_TO_LOOP_DONE 0x80
+
 extern uint8_t i2c0Buffer[I2C_BUFFER_LENGTH];
 extern uint8_t i2c0BufferLength;
+extern uint8_t i2c0_overrun;
+extern unsigned long i2c0_stretch_max;
 
 extern void receive_i2c_event(uint8_t*, uint8_t);
 extern void transmit_i2c_event(void);
+extern void handle_i2c0_receive(void);
 
 // Prototypes for point 2 multipoint commands
 extern void fnMgrAddr(uint8_t*); // 0 for I2C
@@ -21,7 +57,7 @@ extern void fnArduinMode(uint8_t*);  // 3
 extern void fnHostShutdwnMgr(uint8_t*); // 4
 extern void fnHostShutdwnIntAccess(uint8_t*); // 5
 extern void fnHostShutdwnULAccess(uint8_t*); // 6 
-// not used // 7
+extern void fnMultiDropMpcm(uint8_t*); // 7
 
 // Prototypes for PV and Battery Management
 extern void fnBatteryMgr(uint8_t*); // 16 
@@ -30,14 +66,14 @@ extern void fnBatteryULAccess(uint8_t*); // 18
 extern void fnDayNightMgr(uint8_t*); // 19
 extern void fnDayNightIntAccess(uint8_t*); // 20
 extern void fnDayNightULAccess(uint8_t*); // 21
-// not used // 22
-// not used // 23
+extern void fnSnapshot(uint8_t*); // 22
+extern void fnEvents(uint8_t*); // 23
 
 // Prototypes for Analog commands
 extern void fnAnalogRead(uint8_t*); //32
 extern void fnCalibrationRead(uint8_t*); //33
-// not used //34
-// not used //35
+extern void fnAnalogStats(uint8_t*); //34
+extern void fnEnergy(uint8_t*); //35
 extern void fnRdTimedAccum(uint8_t*); //36
 // not used  //37
 extern void fnReferance(uint8_t*); //38
@@ -54,6 +90,16 @@ extern void fnWtXcvrCntlInTestMode(uint8_t*); //51
 // not used  //54
 // not used  //55
 
+// Prototypes for scan time commands
+extern void fnScanTime(uint8_t*); //64
+extern void fnScanTimeReset(uint8_t*); //65
+extern void fnBootTime(uint8_t*); //66
+extern void fnIsrToLoop(uint8_t*); //67
+// not used  //68
+// not used  //69
+// not used  //70
+// not used  //71
+
 /* Dummy function */
 extern  void fnNull(uint8_t*);
 
@@ -35,6 +35,7 @@ SOFTWARE.
 #include <avr/pgmspace.h>
 #include "rpubus_manager_state.h"
 #include "id_in_ee.h"
+#include "param_store.h"
 
 const uint8_t EE_IdTable[] PROGMEM =
 {
@@ -46,36 +47,20 @@ const uint8_t EE_IdTable[] PROGMEM =
     '\0' // null term
 };
 
+// stage the rpu_address and framing for the EEPROM journal (it used to write "RPUid\0" a byte each pass)
 void save_rpu_addr_state(void)
 {
-    if (write_rpu_address_to_eeprom && eeprom_is_ready())
+    if (write_rpu_address_to_eeprom)
     {
-        // up to first EE_RPU_IDMAX locations may be used for writing an ID to the EEPROM
-        if ( (write_rpu_address_to_eeprom >= 1) && (write_rpu_address_to_eeprom <= EE_RPU_IDMAX) )
-        { // write "RPUid\0" at address EE_RPU_ID
-            uint8_t value = pgm_read_byte(&EE_IdTable[write_rpu_address_to_eeprom-1]);
-            eeprom_update_byte( (uint8_t *)((write_rpu_address_to_eeprom-1)+EE_RPU_ID), value);
-            
-            if (value == '\0') 
-            {
-                write_rpu_address_to_eeprom = 11;
-            }
-            else
-            {
-                write_rpu_address_to_eeprom += 1;
-            }
-        }
-        
-        if ( (write_rpu_address_to_eeprom == 11) )
-        { // write the rpu address to eeprom address EE_RPU_ADDRESS 
-            uint8_t value = rpu_address;
-            eeprom_update_byte( (uint8_t *)(EE_RPU_ADDRESS), value);
-            write_rpu_address_to_eeprom = 0;
-        }
+        param.rpu_id = PARAM_RPU_ID_SET;
+        param.rpu_address = rpu_address;
+        param.rpu_mpcm = rpu_mpcm;
+        param_stage(PARAM_RPU_ADDR);
+        write_rpu_address_to_eeprom = 0;
     }
 }
 
-// check if eeprom ID is valid
+// check if eeprom ID is valid (from befor the journal, param_store_load uses it to copy the legacy address)
 uint8_t check_for_eeprom_id(void)
 {
     uint8_t EE_id_valid = 0;
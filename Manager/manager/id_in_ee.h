@@ -6,6 +6,7 @@
 
 #define EE_RPU_ID 40
 #define EE_RPU_ADDRESS 50
+#define EE_RPU_MPCM 51
 
 extern void save_rpu_addr_state(void);
 extern uint8_t check_for_eeprom_id(void);
@@ -35,6 +35,8 @@ SOFTWARE.
 #include <avr/eeprom.h>
 #include <avr/pgmspace.h>
 #include "../lib/timers_bsd.h"
+#include "../lib/sched_bsd.h"
+#include "../lib/idle_bsd.h"
 #include "../lib/twi0_bsd.h"
 #include "../lib/twi1_bsd.h"
 #include "../lib/uart0_bsd.h"
@@ -43,6 +45,7 @@ SOFTWARE.
 #include "rpubus_manager_state.h"
 #include "dtr_transmition.h"
 #include "i2c_cmds.h"
+#include "i2c_callback.h"
 #include "smbus_cmds.h"
 #include "id_in_ee.h"
 #include "adc_burst.h"
@@ -54,6 +57,8 @@ SOFTWARE.
 #include "host_shutdown_limits.h"
 #include "host_shutdown_manager.h"
 #include "calibration_limits.h"
+#include "scan_time.h"
+#include "param_store.h"
 
 void setup(void) 
 {
@@ -107,8 +112,8 @@ void setup(void)
 
     // Initialize ADC and put in Auto Trigger mode to fetch an array of channels
     init_ADC_single_conversion(EXTERNAL_AVCC); // warning AREF must not be connected to anything
+    adc_oversample(ADC_OVERSAMPLE_BITS);
     enable_ADC_auto_conversion(BURST_MODE);
-    adc_started_at = milliseconds();
 
     /* Initialize UART0 to 250 kbps, it returns a pointer to FILE so redirect of stdin and stdout works*/
     stdout = stdin = uart0_init(DTR_BAUD,UART0_RX_REPLACE_CR_WITH_NL);
@@ -130,6 +135,10 @@ void setup(void)
     _delay_ms(50); // wait for UART glitch to clear, blocking at this point is OK.
     ioWrite(MCU_IO_DTR_DE, LOGIC_LEVEL_HIGH);  // then allow DTR pair driver to enable
 
+    // fill the EEPROM shadow from the journal (or the legacy locations), the Load functions use it
+    unsigned long config_load_started = microseconds();
+    param_store_load();
+
     // load references
     ref_loaded = REF_CLEAR;
     for (uint8_t ref_index = 0; ref_index < REFERENCE_OPTIONS; ref_index++)
@@ -137,14 +146,17 @@ void setup(void)
         LoadRefFromEEPROM((REFERENCE_t) ref_index);
     }
 
-    // Use eeprom value for rpu_address if ID was valid    
-    if (check_for_eeprom_id())
+    // Use eeprom value for rpu_address if it was saved
+    if (param.rpu_id == PARAM_RPU_ID_SET)
     {
-        rpu_address = eeprom_read_byte((uint8_t*)(EE_RPU_ADDRESS));
+        rpu_address = param.rpu_address;
+        rpu_mpcm = param.rpu_mpcm;
+        if (rpu_mpcm != RPU_MPCM_ON) rpu_mpcm = RPU_MPCM_OFF; // a blank location (0xFF) is off
     }
     else
     {
         rpu_address = RPU_ADDRESS;
+        rpu_mpcm = RPU_MPCM_OFF;
     }
 
     // load Battery Limits from EEPROM (or set defaults)
@@ -163,6 +175,7 @@ void setup(void)
     {
         LoadCalFromEEPROM( (ADC_ENUM_t) cal_index);
     }
+    config_load_usec = microseconds() - config_load_started;
 
     // The manager's default is to power up the host when power is applied even if it is held in reset.
     // The goal now is to lockout the shutdown switch for some amount of time to match what the hs daemon does.
@@ -188,6 +201,51 @@ void setup(void)
     // status_byt was zero at this point, but this sets the bit without changing the other bits
     status_byt |= (1<<HOST_LOCKOUT_STATUS);
 #endif
+
+    // Timer0 started at initTimers(), what was done befor it is a few register writes
+    boot_usec = microseconds();
+}
+
+// time each task that the scheduler ran
+static void task_done(uint8_t id)
+{
+    scan_time_task( (SCAN_TASK_t) id);
+}
+
+// a byte left in the UART0 buffer is an event, so check_uart runs on the next pass rather than after a sleep
+static uint8_t uart_pending(void)
+{
+    if (!uart0_available()) return 0;
+    sched_event(SCHED_EVENT_UART0);
+    return 1;
+}
+
+// tasks are added in SCAN_TASK_t order, so the scheduler id is the scan task.
+// A period (mSec) is a deadline that does not drift, an event (see sched_bsd.h) runs the task on the next pass.
+static void add_tasks(void)
+{
+    sched_add(blink_on_activate, 10, 0);
+    sched_add(check_Bootload_Time, 10, 0);
+    sched_add(check_DTR, 1, 0); // nRTS from the host is polled
+    sched_add(check_lockout, 10, 0);
+    sched_add(handle_i2c0_receive, 0, SCHED_EVENT_TWI0); // SCL is held until the reply is ready
+    sched_add(save_rpu_addr_state, 10, 0);
+    sched_add(check_uart, 1, SCHED_EVENT_UART0);
+    sched_add(adc_burst, ADC_DELAY_MILSEC, 0); // coulomb counting needs a period that does not drift
+    sched_add(ReferanceFromI2CtoEE, 10, 0);
+    sched_add(ChannelCalFromI2CtoEE, 10, 0);
+    sched_add(BatLimitsFromI2CtoEE, 10, 0);
+    sched_add(check_battery_manager, 0, SCHED_EVENT_ADC);
+    sched_add(DayNightValuesFromI2CtoEE, 10, 0);
+    sched_add(check_daynight, 0, SCHED_EVENT_ADC);
+    sched_add(ShtDwnLimitsFromI2CtoEE, 10, 0);
+    sched_add(check_if_host_should_be_on, 10, SCHED_EVENT_ADC);
+    sched_add(i2c_callback_pump, 1, 0);
+    sched_add(handle_smbus_receive, 0, SCHED_EVENT_TWI1);
+    sched_add(param_store_commit, 1, 0); // an EEPROM byte takes about 3.4mSec
+    sched_registerTaskDoneCallback(task_done);
+    idle_registerPending(sched_pending);
+    idle_registerPending(uart_pending);
 }
 
 int main(void)
@@ -196,27 +254,16 @@ int main(void)
 
     blink_started_at = milliseconds();
 
-    while (1) // scan time for each loop varies depending on how much of each thing needs to be done 
+    add_tasks();
+
+    while (1) // each pass runs the tasks that are due, when none are it sleeps until an interrupt (see scan_time.h)
     {
-        if (!test_mode) 
+        scan_time_start();
+        if (!sched_run())
         {
-            blink_on_activate();
-            check_Bootload_Time();
-            check_DTR();
-            check_lockout();
+            idle_sleep();
+            scan_time_idle();
         }
-        save_rpu_addr_state();
-        check_uart();
-        adc_burst();
-        ReferanceFromI2CtoEE();
-        ChannelCalFromI2CtoEE();
-        BatLimitsFromI2CtoEE();
-        check_battery_manager();
-        DayNightValuesFromI2CtoEE();
-        check_daynight();
-        ShtDwnLimitsFromI2CtoEE();
-        check_if_host_should_be_on();
-        handle_smbus_receive();
     }    
 }
 
@@ -0,0 +1,234 @@
+/*
+param_store keeps the manager settings in a wear leveled EEPROM journal
+Copyright (C) 2020 Ronald Sutherland
+
+All rights reserved, specifically, the right to Redistribut is withheld. Subject 
+to your compliance with these terms, you may use this software and derivatives. 
+
+Use in source and binary forms, with or without modification, are permitted 
+provided that the following conditions are met:
+1. Source code must retain the above copyright notice, this list of 
+conditions and the following disclaimer.
+2. Binary derivatives are exclusively for use with Ronald Sutherland 
+products.
+3. Neither the name of the copyright holders nor the names of its
+contributors may be used to endorse or promote products derived from
+this software without specific prior written permission.
+
+THIS SOFTWARE IS SUPPLIED BY RONALD SUTHERLAND "AS IS". NO WARRANTIES, WHETHER
+EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY
+IMPLIED WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS
+FOR A PARTICULAR PURPOSE.
+
+IN NO EVENT WILL RONALD SUTHERLAND BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF RONALD SUTHERLAND
+HAS BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO
+THE FULLEST EXTENT ALLOWED BY LAW, RONALD SUTHERLAND'S TOTAL LIABILITY ON ALL
+CLAIMS IN ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT
+OF FEES, IF ANY, THAT YOU HAVE PAID DIRECTLY TO RONALD SUTHERLAND FOR THIS
+SOFTWARE.
+*/
+
+#include <stddef.h>
+#include <avr/io.h>
+#include <avr/eeprom.h>
+#include <avr/pgmspace.h>
+#include <util/crc16.h>
+#include "../lib/timers_bsd.h"
+#include "references.h"
+#include "calibration_limits.h"
+#include "battery_limits.h"
+#include "daynight_limits.h"
+#include "host_shutdown_limits.h"
+#include "id_in_ee.h"
+#include "param_store.h"
+
+_Static_assert(sizeof(PARAM_IMAGE_t) <= EE_PARAM_SLOT_SIZE, "PARAM_IMAGE_t does not fit in a journal slot");
+_Static_assert(PARAM_END <= 32, "param_dirty has a bit for each PARAM_ID_t");
+_Static_assert(EE_PARAM_SLOTS <= 16, "param_store_load keeps a bit for each slot it has tried");
+_Static_assert((EE_PARAM_JOURNAL_ADDR + (EE_PARAM_SLOT_SIZE * EE_PARAM_SLOTS)) <= (E2END + 1), "journal does not fit in EEPROM");
+
+PARAM_IMAGE_t param;
+uint32_t param_dirty;
+PARAM_SOURCE_t param_source;
+
+// used as a whole when no slot is good, battery limits of zero are not valid so LoadBatLimitsFromEEPROM picks them from the battery voltage
+static const PARAM_IMAGE_t param_default PROGMEM = {
+    .version = PARAM_IMAGE_VERSION,
+    .reference = {
+        [REFERENCE_EXTERN_AVCC] = 5.0,
+        [REFERENCE_INTERN_1V1] = 1.08
+    },
+    .calibration = {
+        [ADC_ENUM_ALT_I] = (1.0/(1<<10))/(0.018*50.0), // ALT_I has  0.018 Ohm sense resistor and gain of 50
+        [ADC_ENUM_ALT_V] = (1.0/(1<<10))*((100+10.0)/10.0), // ALT_V has divider with 100k and 10.0k
+        [ADC_ENUM_PWR_I] = (1.0/(1<<10))/(0.068*50.0), // PWR_I has 0.068 Ohm sense resistor and gain of 50
+        [ADC_ENUM_PWR_V] = (1.0/(1<<10))*((100+15.8)/15.8) // PWR_V has divider with 100k and 15.8k
+    },
+    .daynight_morning_threshold = 80,
+    .daynight_evening_threshold = 40,
+    .daynight_morning_debounce = 1200000UL,
+    .daynight_evening_debounce = 1200000UL,
+    .shutdown_halt_curr_limit = 30,
+    .shutdown_ttl_limit = 90000UL,
+    .shutdown_delay_limit = 40000UL,
+    .shutdown_wearleveling_limit = 1000UL
+};
+
+// the first bytes of a slot, they are read for all slots so only one whole slot needs to be read
+typedef struct {
+    uint16_t sequence;
+    uint8_t version;
+} PARAM_HEADER_t;
+
+// the image being written is a copy, so values staged during a commit wait for the next one
+static PARAM_IMAGE_t param_write;
+static uint8_t param_slot; // slot with the newest image (or being written)
+static uint8_t param_write_index;
+static unsigned long param_staged_at;
+
+#define PARAM_WRITE_IDLE 0xFF
+
+static uint16_t param_crc(PARAM_IMAGE_t *image)
+{
+    uint16_t crc = 0xFFFF;
+    uint8_t *data = (uint8_t *) image;
+    for (uint8_t i = 0; i < offsetof(PARAM_IMAGE_t, crc); i++)
+    {
+        crc = _crc_ccitt_update(crc, data[i]);
+    }
+    return crc;
+}
+
+static uint8_t *slot_address(uint8_t slot)
+{
+    return (uint8_t *) (EE_PARAM_JOURNAL_ADDR + (EE_PARAM_SLOT_SIZE * slot));
+}
+
+// values were at fixed places befor the journal, they are copied as is since each is checked when loaded
+static void param_from_legacy(void)
+{
+    for (uint8_t ref_index = 0; ref_index < REFERENCE_OPTIONS; ref_index++)
+    {
+        param.reference[ref_index] = eeprom_read_float((float *)(EE_REF_BASE_ADDR+(EE_REF_OFFSET*ref_index)));
+    }
+    for (uint8_t cal_index = 0; cal_index < ADC_ENUM_END; cal_index++)
+    {
+        param.calibration[cal_index] = eeprom_read_float((float *)(EE_CAL_BASE_ADDR+(EE_CAL_OFFSET*cal_index)));
+    }
+    param.bat_high_limit = eeprom_read_word((uint16_t*)(EE_BAT_LIMIT_ADDR+EE_BAT_LIMIT_OFFSET_HIGH));
+    param.bat_low_limit = eeprom_read_word((uint16_t*)(EE_BAT_LIMIT_ADDR+EE_BAT_LIMIT_OFFSET_LOW));
+    param.bat_host_limit = eeprom_read_word((uint16_t*)(EE_BAT_LIMIT_ADDR+EE_BAT_LIMIT_OFFSET_HOST));
+    param.daynight_morning_threshold = eeprom_read_word((uint16_t*)(EE_DAYNIGHT_ADDR+EE_DAYNIGHT_MORNING_THRESHOLD_OFFSET));
+    param.daynight_evening_threshold = eeprom_read_word((uint16_t*)(EE_DAYNIGHT_ADDR+EE_DAYNIGHT_EVENING_THRESHOLD_OFFSET));
+    param.daynight_morning_debounce = eeprom_read_dword((uint32_t*)(EE_DAYNIGHT_ADDR+EE_DAYNIGHT_MORNING_DEBOUNCE_OFFSET));
+    param.daynight_evening_debounce = eeprom_read_dword((uint32_t*)(EE_DAYNIGHT_ADDR+EE_DAYNIGHT_EVENING_DEBOUNCE_OFFSET));
+    param.shutdown_halt_curr_limit = eeprom_read_word((uint16_t*)(EE_HOSTSHUTDOWN_LIMIT_ADDR+EE_HOSTSHUTDOWN_LIM_HALTCURR_LIMIT));
+    param.shutdown_ttl_limit = eeprom_read_dword((uint32_t*)(EE_HOSTSHUTDOWN_LIMIT_ADDR+EE_HOSTSHUTDOWN_LIM_HALT_TTL));
+    param.shutdown_delay_limit = eeprom_read_dword((uint32_t*)(EE_HOSTSHUTDOWN_LIMIT_ADDR+EE_HOSTSHUTDOWN_LIM_DELAY));
+    param.shutdown_wearleveling_limit = eeprom_read_dword((uint32_t*)(EE_HOSTSHUTDOWN_LIMIT_ADDR+EE_HOSTSHUTDOWN_LIM_WEARLEVELING));
+    param.rpu_id = 0;
+    if (check_for_eeprom_id())
+    {
+        param.rpu_id = PARAM_RPU_ID_SET;
+        param.rpu_address = eeprom_read_byte((uint8_t*)(EE_RPU_ADDRESS));
+        param.rpu_mpcm = eeprom_read_byte((uint8_t*)(EE_RPU_MPCM));
+    }
+}
+
+// pick the newest slot (from the headers) that has not been tried, EE_PARAM_SLOTS if none are left
+static uint8_t newest_slot(PARAM_HEADER_t *header, uint16_t tried)
+{
+    uint8_t newest = EE_PARAM_SLOTS;
+    for (uint8_t slot = 0; slot < EE_PARAM_SLOTS; slot++)
+    {
+        if ( (tried & (1<<slot)) || (header[slot].version != PARAM_IMAGE_VERSION) ) continue;
+        if ( (newest == EE_PARAM_SLOTS) || ((int16_t)(header[slot].sequence - header[newest].sequence) > 0) )
+        {
+            newest = slot;
+        }
+    }
+    return newest;
+}
+
+// fill the shadow with one block read of the newest slot that has a good crc, call befor the Load*FromEEPROM functions.
+// A commit writes the sequence first and the crc last, so a slot that was cut short looks newest but fails the crc 
+// and the slot befor it is read. If the journal is blank (e.g., first power up after it was added) the legacy values 
+// are used, if no slot is good the defaults in flash are used as a whole. Either is then committed.
+void param_store_load(void)
+{
+    PARAM_HEADER_t header[EE_PARAM_SLOTS];
+    uint8_t blank = 1;
+    for (uint8_t slot = 0; slot < EE_PARAM_SLOTS; slot++)
+    {
+        eeprom_read_block(&header[slot], slot_address(slot), sizeof(PARAM_HEADER_t));
+        if ( (header[slot].sequence != 0xFFFF) || (header[slot].version != 0xFF) ) blank = 0;
+    }
+    param_write_index = PARAM_WRITE_IDLE;
+    param_dirty = 0;
+    uint16_t tried = 0;
+    uint8_t slot;
+    while ( (slot = newest_slot(header, tried)) < EE_PARAM_SLOTS )
+    {
+        tried |= (1<<slot);
+        eeprom_read_block(&param, slot_address(slot), sizeof(PARAM_IMAGE_t));
+        if ( (param.sequence == header[slot].sequence) && (param_crc(&param) == param.crc) )
+        {
+            param_slot = slot;
+            param_source = PARAM_SOURCE_JOURNAL;
+            return;
+        }
+    }
+    if (blank)
+    {
+        param_from_legacy();
+        param_source = PARAM_SOURCE_LEGACY;
+    }
+    else
+    {
+        memcpy_P(&param, &param_default, sizeof(PARAM_IMAGE_t));
+        param_source = PARAM_SOURCE_DEFAULT;
+    }
+    param.sequence = 0;
+    param.version = PARAM_IMAGE_VERSION;
+    param_slot = EE_PARAM_SLOTS - 1; // so the first commit is in slot 0
+    param_stage(PARAM_REF); // any bit will commit the whole image
+}
+
+// the caller has changed a value in param, it is committed after PARAM_COMMIT_SETTLE
+void param_stage(PARAM_ID_t id)
+{
+    param_dirty |= (1UL<<id);
+    param_staged_at = milliseconds();
+}
+
+// call from the main loop, it does not wait for the EEPROM. 
+// At most one byte is burned each pass (about 3.4mSec each), the update function skips bytes that are the same.
+void param_store_commit(void)
+{
+    if (param_write_index == PARAM_WRITE_IDLE)
+    {
+        if ( !param_dirty || (elapsed(&param_staged_at) < PARAM_COMMIT_SETTLE) )
+        {
+            return;
+        }
+        param.sequence++;
+        param.crc = param_crc(&param);
+        param_write = param;
+        param_dirty = 0;
+        param_slot = (param_slot + 1) % EE_PARAM_SLOTS;
+        param_write_index = 0;
+    }
+    uint8_t *image = (uint8_t *) &param_write;
+    uint8_t *slot = slot_address(param_slot);
+    while ( eeprom_is_ready() )
+    {
+        eeprom_update_byte(slot + param_write_index, image[param_write_index]);
+        if (++param_write_index >= sizeof(PARAM_IMAGE_t))
+        {
+            param_write_index = PARAM_WRITE_IDLE; // the crc was the last thing written
+            return;
+        }
+    }
+}
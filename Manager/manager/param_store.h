@@ -0,0 +1,78 @@
+#ifndef Param_Store_H
+#define Param_Store_H
+
+// use REFERENCE_OPTIONS and ADC_ENUM_END for array size
+#include "../lib/adc_bsd.h"
+
+// EEPROM memory usage (see README.md), the journal is a ring of slots that each hold a whole image.
+// A commit goes in the slot after the last one, so a cell is written once for every EE_PARAM_SLOTS commits.
+#define EE_PARAM_JOURNAL_ADDR 256
+#define EE_PARAM_SLOT_SIZE 64
+#define EE_PARAM_SLOTS 12
+
+// staged values are held this long so a group of I2C changes goes in one commit
+#define PARAM_COMMIT_SETTLE 500UL
+
+#define PARAM_RPU_ID_SET 0x5A
+
+// change when PARAM_IMAGE_t changes, a slot with another version is not loaded
+#define PARAM_IMAGE_VERSION 1
+
+// the image in RAM (param) is the shadow of the newest valid slot, the crc is over the bytes befor it
+typedef struct {
+    uint16_t sequence; // newest slot has the largest sequence (serial number arithmetic)
+    uint8_t version; // PARAM_IMAGE_VERSION
+    float reference[REFERENCE_OPTIONS];
+    float calibration[ADC_ENUM_END];
+    uint16_t bat_high_limit;
+    uint16_t bat_low_limit;
+    uint16_t bat_host_limit;
+    uint16_t daynight_morning_threshold;
+    uint16_t daynight_evening_threshold;
+    uint32_t daynight_morning_debounce;
+    uint32_t daynight_evening_debounce;
+    uint16_t shutdown_halt_curr_limit;
+    uint32_t shutdown_ttl_limit;
+    uint32_t shutdown_delay_limit;
+    uint32_t shutdown_wearleveling_limit;
+    uint8_t rpu_id; // PARAM_RPU_ID_SET if rpu_address and rpu_mpcm were saved
+    uint8_t rpu_address;
+    uint8_t rpu_mpcm;
+    uint16_t crc; // CCITT (0xFFFF start), it is written last
+} PARAM_IMAGE_t;
+
+// a bit in param_dirty for each value (or group) that has been staged but not committed
+typedef enum PARAM_ID_enum {
+    PARAM_REF, // REFERENCE_OPTIONS bits
+    PARAM_CAL = PARAM_REF + REFERENCE_OPTIONS, // ADC_ENUM_END bits
+    PARAM_BAT_HIGH = PARAM_CAL + ADC_ENUM_END,
+    PARAM_BAT_LOW,
+    PARAM_BAT_HOST,
+    PARAM_DAYNIGHT_MORNING_THRESHOLD,
+    PARAM_DAYNIGHT_EVENING_THRESHOLD,
+    PARAM_DAYNIGHT_MORNING_DEBOUNCE,
+    PARAM_DAYNIGHT_EVENING_DEBOUNCE,
+    PARAM_SHUTDOWN_HALT_CURR,
+    PARAM_SHUTDOWN_HALT_TTL,
+    PARAM_SHUTDOWN_DELAY,
+    PARAM_SHUTDOWN_WEARLEVELING,
+    PARAM_RPU_ADDR, // rpu_id, rpu_address and rpu_mpcm
+    PARAM_END
+} PARAM_ID_t;
+
+// where the shadow came from at power up
+typedef enum PARAM_SOURCE_enum {
+    PARAM_SOURCE_JOURNAL, // newest slot with a good crc
+    PARAM_SOURCE_LEGACY, // journal was blank, values were copied from where they were kept befor the journal
+    PARAM_SOURCE_DEFAULT // no slot was good (e.g., a commit was cut short with no older slot), defaults from flash
+} PARAM_SOURCE_t;
+
+extern PARAM_IMAGE_t param;
+extern uint32_t param_dirty;
+extern PARAM_SOURCE_t param_source;
+
+extern void param_store_load(void);
+extern void param_stage(PARAM_ID_t);
+extern void param_store_commit(void);
+
+#endif // Param_Store_H
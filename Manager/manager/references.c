@@ -31,15 +31,16 @@ SOFTWARE.
 */
 #include <avr/pgmspace.h>
 #include <util/atomic.h>
-#include <avr/eeprom.h> 
 #include <stdio.h>
 #include <stdlib.h>
 #include <ctype.h>
 #include <string.h>
 #include "references.h"
+#include "param_store.h"
 
 volatile uint8_t ref_loaded;
 volatile uint8_t ref_select_with_writebit;
+volatile uint8_t analog_generation;
 
 struct Ref_Map refMap[REFERENCE_OPTIONS];
 
@@ -60,17 +61,16 @@ uint8_t IsValidValForRef(REFERENCE_t ref_map)
     return 1;
 }
 
-// save channel reference if writebit is set and eeprom is ready
+// stage channel reference for the EEPROM journal if writebit is set (param_store_commit does the burning)
 uint8_t WriteRefToEE() 
 {
     if (ref_select_with_writebit & 0x80)
     {
         uint8_t select  = ref_select_with_writebit & 0x7F; // mask the writebit to select the reference
-        // use update functions to skip the burning if the old value is the same with new.
-        // https://www.microchip.com/webdoc/AVRLibcReferenceManual/group__avr__eeprom.html
-        if ( eeprom_is_ready() )
+        if (select < REFERENCE_OPTIONS)
         {
-            eeprom_update_float( (float *)(EE_REF_BASE_ADDR+(EE_REF_OFFSET*select)), refMap[select].reference);
+            param.reference[select] = refMap[select].reference;
+            param_stage( (PARAM_ID_t) (PARAM_REF + select) );
             ref_select_with_writebit = select;
             return 1;
         }
@@ -78,7 +78,7 @@ uint8_t WriteRefToEE()
     return 0;
 }
 
-// load a reference from EEPROM or set default if not valid (0 or 0xFFFFFFFF are not valid).
+// load a reference from the EEPROM shadow (param_store_load) or set default if not valid (0 or 0xFFFFFFFF are not valid).
 // Befor loading references from EEPROM set 
 // ref_loaded = REF_CLEAR; 
 // then loop load reference for each enum in REFERENCE_t
@@ -86,7 +86,7 @@ void LoadRefFromEEPROM(REFERENCE_t ref_map)
 {
     if (ref_map < REFERENCE_OPTIONS) // ignore if out of range
     {
-        refMap[ref_map].reference = eeprom_read_float((float *)(EE_REF_BASE_ADDR+(EE_REF_OFFSET*ref_map)));
+        refMap[ref_map].reference = param.reference[ref_map];
         if ( !IsValidValForRef(ref_map) ) 
         {
             if (ref_map == REFERENCE_EXTERN_AVCC)
@@ -110,6 +110,14 @@ void LoadRefFromEEPROM(REFERENCE_t ref_map)
     }
 }
 
+// the application compares this with the value it saw when it got a copy of the references and calibrations
+void bump_analog_generation(void)
+{
+    uint8_t next = analog_generation + 1;
+    if (next == ANALOG_GENERATION_NONE) next = 0;
+    analog_generation = next;
+}
+
 // save referances from I2C to EEPROM (if valid)
 void ReferanceFromI2CtoEE(void)
 {
@@ -130,12 +138,15 @@ void ReferanceFromI2CtoEE(void)
                     // also clear the correct REF_n_DEFAULT bit (referance is not default)
                     uint8_t mask_for_ref_default_bit = ~(1<<select);
                     ref_loaded = ref_loaded & mask_for_ref_default_bit; // now clear the REF_n_DEFAULT bit
+                    bump_analog_generation();
                     return; // all done
                 }
             }
             else
             {
                 LoadRefFromEEPROM((REFERENCE_t) select); // ignore value since it is not valid
+                ref_loaded = ref_loaded & 0x0F; // clear the REF_n_TOSAVE bits so it is not loaded again
+                bump_analog_generation();
             }
    
         }
@@ -4,7 +4,7 @@
 // use REFERENCE_enum for: EXTERN_AVCC, INTERN_1V1, REFERENCE_OPTIONS
 #include "../lib/adc_bsd.h"
 
-//EEPROM memory usage (see README.md). 
+//EEPROM memory usage befor the journal (see param_store.h), it is copied once. 
 #define EE_REF_BASE_ADDR 30
 // EEPROM byte offset to each reference value
 #define EE_REF_OFFSET 4
@@ -31,6 +31,11 @@ extern void ReferanceFromI2CtoEE();
 #define REF_1_TOSAVE 0x20
 extern volatile uint8_t ref_loaded;
 
+// bumped when a reference or calibration has changed, so the application can keep a copy (0xFF is not used)
+#define ANALOG_GENERATION_NONE 0xFF
+extern volatile uint8_t analog_generation;
+extern void bump_analog_generation(void);
+
 #define REF_SELECT_WRITEBIT 0x80 
 #define REF_SELECT_MASK 0x7F
 extern volatile uint8_t ref_select_with_writebit;
@@ -53,6 +53,7 @@ uint8_t host_is_foreign;
 uint8_t local_mcu_is_rpu_aware;
 uint8_t rpu_address;
 uint8_t write_rpu_address_to_eeprom;
+uint8_t rpu_mpcm;
 uint8_t shutdown_detected;
 uint8_t shutdown_started;
 uint8_t arduino_mode_started;
@@ -101,6 +102,8 @@ void connect_normal_mode(void)
 // blink if the host is active, fast blink if status_byt, slow blink in lockout
 void blink_on_activate(void)
 {
+    if (test_mode) return;
+
     // do not blink when host is being shutdown, e.g. states between up and down
     if ( (shutdown_state > HOSTSHUTDOWN_STATE_UP) && (shutdown_state < HOSTSHUTDOWN_STATE_DOWN) )  
     {
@@ -156,6 +159,7 @@ void blink_on_activate(void)
 
 void check_Bootload_Time(void)
 {
+    if (test_mode) return;
     if (bootloader_started)
     {
         unsigned long kRuntime = elapsed(&bootloader_started_at);
@@ -173,6 +177,7 @@ void check_Bootload_Time(void)
 // lockout needs to happoen for a long enough time to insure bootloading is finished,
 void check_lockout(void)
 {
+    if (test_mode) return;
     unsigned long kRuntime = elapsed(&lockout_started_at);
     
     if (!arduino_mode && ( lockout_active && (kRuntime > LOCKOUT_DELAY) ))
@@ -21,6 +21,11 @@
 
 #define SHUTDOWN_TIME 1000
 
+// multi-drop framing used by the application controller (rpu_mpcm)
+// RPU_MPCM_ON has the host send the rpu_address as a 9 bit address frame before each command line
+#define RPU_MPCM_OFF 0
+#define RPU_MPCM_ON 1
+
 extern unsigned long blink_started_at;
 extern unsigned long lockout_started_at;
 extern unsigned long bootloader_started_at;
@@ -35,6 +40,7 @@ extern uint8_t host_is_foreign;
 extern uint8_t local_mcu_is_rpu_aware;
 extern uint8_t rpu_address;
 extern uint8_t write_rpu_address_to_eeprom;
+extern uint8_t rpu_mpcm;
 extern uint8_t shutdown_detected;
 extern uint8_t shutdown_started;
 extern uint8_t arduino_mode_started;
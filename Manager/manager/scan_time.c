@@ -0,0 +1,114 @@
+/*
+scan_time measures how long each task in the main loop takes
+Copyright (C) 2020 Ronald Sutherland
+
+All rights reserved, specifically, the right to Redistribut is withheld. Subject 
+to your compliance with these terms, you may use this software and derivatives. 
+
+Use in source and binary forms, with or without modification, are permitted 
+provided that the following conditions are met:
+1. Source code must retain the above copyright notice, this list of 
+conditions and the following disclaimer.
+2. Binary derivatives are exclusively for use with Ronald Sutherland 
+products.
+3. Neither the name of the copyright holders nor the names of its
+contributors may be used to endorse or promote products derived from
+this software without specific prior written permission.
+
+THIS SOFTWARE IS SUPPLIED BY RONALD SUTHERLAND "AS IS". NO WARRANTIES, WHETHER
+EXPRESS, IMPLIED OR STATUTORY, APPLY TO THIS SOFTWARE, INCLUDING ANY
+IMPLIED WARRANTIES OF NON-INFRINGEMENT, MERCHANTABILITY, AND FITNESS
+FOR A PARTICULAR PURPOSE.
+
+IN NO EVENT WILL RONALD SUTHERLAND BE LIABLE FOR ANY INDIRECT, SPECIAL, PUNITIVE,
+INCIDENTAL OR CONSEQUENTIAL LOSS, DAMAGE, COST OR EXPENSE OF ANY KIND
+WHATSOEVER RELATED TO THE SOFTWARE, HOWEVER CAUSED, EVEN IF RONALD SUTHERLAND
+HAS BEEN ADVISED OF THE POSSIBILITY OR THE DAMAGES ARE FORESEEABLE. TO
+THE FULLEST EXTENT ALLOWED BY LAW, RONALD SUTHERLAND'S TOTAL LIABILITY ON ALL
+CLAIMS IN ANY WAY RELATED TO THIS SOFTWARE WILL NOT EXCEED THE AMOUNT
+OF FEES, IF ANY, THAT YOU HAVE PAID DIRECTLY TO RONALD SUTHERLAND FOR THIS
+SOFTWARE.
+*/
+
+#include <avr/io.h>
+#include "../lib/timers_bsd.h"
+#include "scan_time.h"
+
+SCAN_TIME_t scan_time[SCAN_TASK_END];
+uint32_t boot_usec;
+uint32_t config_load_usec;
+
+static uint32_t task_started_at; // Timer0 counts when the last task was done
+static uint32_t loop_started_at;
+static uint8_t loop_started;
+
+static void scan_time_record(SCAN_TASK_t task, uint32_t counts)
+{
+    uint16_t took = (counts > 0xFFFF) ? 0xFFFF : (uint16_t) counts;
+    SCAN_TIME_t *st = &scan_time[task];
+    if (st->count == 0xFFFF)
+    {
+        st->sum = st->sum >> 1;
+        st->count = st->count >> 1;
+        for (uint8_t i = 0; i < SCAN_TIME_BINS; i++)
+        {
+            st->bin[i] = st->bin[i] >> 1;
+        }
+    }
+    if ( (st->count == 0) || (took < st->min) ) st->min = took;
+    if (took > st->max) st->max = took;
+    st->sum += took;
+    st->count++;
+    if (took < 16) st->bin[0]++;
+    else if (took < 64) st->bin[1]++;
+    else if (took < 256) st->bin[2]++;
+    else st->bin[3]++;
+}
+
+// call at the top of the main loop, it records the last pass as SCAN_TASK_LOOP
+void scan_time_start(void)
+{
+    uint32_t now = timer0CountsAtomic();
+    if (loop_started)
+    {
+        scan_time_record(SCAN_TASK_LOOP, now - loop_started_at);
+    }
+    loop_started = 1;
+    loop_started_at = now;
+    task_started_at = now;
+}
+
+// call after a task is done, the time since the last task that ran (or the loop start) is recorded for it
+void scan_time_task(SCAN_TASK_t task)
+{
+    if (!loop_started) return;
+    uint32_t now = timer0CountsAtomic();
+    scan_time_record(task, now - task_started_at);
+    task_started_at = now;
+}
+
+// call after the loop slept, the pass is recorded as SCAN_TASK_IDLE rather than SCAN_TASK_LOOP
+void scan_time_idle(void)
+{
+    if (!loop_started) return;
+    scan_time_record(SCAN_TASK_IDLE, timer0CountsAtomic() - loop_started_at);
+    loop_started = 0;
+}
+
+// clear the times, the pass that is running when this is done is not counted
+void scan_time_reset(void)
+{
+    for (uint8_t task = 0; task < SCAN_TASK_END; task++)
+    {
+        SCAN_TIME_t *st = &scan_time[task];
+        st->min = 0;
+        st->max = 0;
+        st->sum = 0;
+        st->count = 0;
+        for (uint8_t i = 0; i < SCAN_TIME_BINS; i++)
+        {
+            st->bin[i] = 0;
+        }
+    }
+    loop_started = 0;
+}
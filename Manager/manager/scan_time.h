@@ -0,0 +1,53 @@
+#ifndef Scan_Time_H
+#define Scan_Time_H
+
+// tasks in the order main() adds them to the scheduler, SCAN_TASK_IDLE is a sleep, SCAN_TASK_LOOP is a pass that ran tasks.
+typedef enum SCAN_TASK_enum {
+    SCAN_TASK_BLINK, // blink_on_activate
+    SCAN_TASK_BOOTLOAD, // check_Bootload_Time
+    SCAN_TASK_DTR, // check_DTR
+    SCAN_TASK_LOCKOUT, // check_lockout
+    SCAN_TASK_I2C0, // handle_i2c0_receive
+    SCAN_TASK_RPU_ADDR, // save_rpu_addr_state
+    SCAN_TASK_UART, // check_uart
+    SCAN_TASK_ADC, // adc_burst
+    SCAN_TASK_REF_EE, // ReferanceFromI2CtoEE
+    SCAN_TASK_CAL_EE, // ChannelCalFromI2CtoEE
+    SCAN_TASK_BAT_EE, // BatLimitsFromI2CtoEE
+    SCAN_TASK_BATTERY, // check_battery_manager
+    SCAN_TASK_DN_EE, // DayNightValuesFromI2CtoEE
+    SCAN_TASK_DAYNIGHT, // check_daynight
+    SCAN_TASK_HS_EE, // ShtDwnLimitsFromI2CtoEE
+    SCAN_TASK_SHUTDOWN, // check_if_host_should_be_on
+    SCAN_TASK_CALLBACK, // i2c_callback_pump
+    SCAN_TASK_SMBUS, // handle_smbus_receive
+    SCAN_TASK_PARAM_EE, // param_store_commit
+    SCAN_TASK_IDLE, // idle_sleep
+    SCAN_TASK_LOOP,
+    SCAN_TASK_END
+} SCAN_TASK_t;
+
+// times are Timer0 counts (64 crystal counts, 5.333uSec at 12MHz), the histogram bins are 
+// [0] under 16 counts (85uSec), [1] under 64 (341uSec), [2] under 256 (1.37mSec), [3] the rest.
+#define SCAN_TIME_BINS 4
+
+typedef struct {
+    uint16_t min;
+    uint16_t max;
+    uint32_t sum; // sum and count are halved (with the bins) when count is full, so the mean keeps up with recent scans
+    uint16_t count;
+    uint16_t bin[SCAN_TIME_BINS];
+} SCAN_TIME_t;
+
+extern SCAN_TIME_t scan_time[SCAN_TASK_END];
+
+// set by setup(), boot_usec includes the 50mSec wait for the UART glitch to clear
+extern uint32_t boot_usec; // Timer0 start to the end of setup()
+extern uint32_t config_load_usec; // param_store_load() through the Load*FromEEPROM functions
+
+extern void scan_time_start(void);
+extern void scan_time_task(SCAN_TASK_t task);
+extern void scan_time_idle(void);
+extern void scan_time_reset(void);
+
+#endif // Scan_Time_H 
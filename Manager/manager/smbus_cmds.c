@@ -35,6 +35,7 @@ SOFTWARE.
 #include <util/delay.h>
 #include "../lib/twi1_bsd.h"
 #include "../lib/uart0_bsd.h"
+#include "../lib/sched_bsd.h"
 #include "rpubus_manager_state.h"
 #include "i2c_cmds.h"
 #include "smbus_cmds.h"
@@ -56,6 +57,7 @@ void receive_smbus_event(uint8_t* inBytes, uint8_t numBytes)
 {
     inBytes_to_handle = inBytes;
     smbus_has_numBytes_to_handle = numBytes;
+    sched_event(SCHED_EVENT_TWI1);
 }
 
 // twi1.c has been modified, so it has an interleaved buffer that allows  
@@ -67,10 +69,11 @@ void handle_smbus_receive(void)
         // table of pointers to functions that are selected by the i2c cmmand byte
         static void (*pf[GROUP][MGR_CMDS])(uint8_t*) = 
         {
-            {fnMgrAddrQuietly, fnStatus, fnBootldAddr, fnArduinMode, fnHostShutdwnMgr, fnHostShutdwnIntAccess, fnHostShutdwnULAccess, fnNull},
-            {fnBatteryMgr, fnBatteryIntAccess, fnBatteryULAccess, fnDayNightMgr, fnDayNightIntAccess, fnDayNightULAccess, fnNull, fnNull},
-            {fnAnalogRead, fnCalibrationRead, fnNull, fnNull, fnRdTimedAccum, fnNull, fnReferance, fnNull},
-            {fnStartTestMode, fnEndTestMode, fnRdXcvrCntlInTestMode, fnWtXcvrCntlInTestMode, fnNull, fnNull, fnNull, fnNull}
+            {fnMgrAddrQuietly, fnStatus, fnBootldAddr, fnArduinMode, fnHostShutdwnMgr, fnHostShutdwnIntAccess, fnHostShutdwnULAccess, fnMultiDropMpcm},
+            {fnBatteryMgr, fnBatteryIntAccess, fnBatteryULAccess, fnDayNightMgr, fnDayNightIntAccess, fnDayNightULAccess, fnSnapshot, fnEvents},
+            {fnAnalogRead, fnCalibrationRead, fnAnalogStats, fnEnergy, fnRdTimedAccum, fnNull, fnReferance, fnNull},
+            {fnStartTestMode, fnEndTestMode, fnRdXcvrCntlInTestMode, fnWtXcvrCntlInTestMode, fnNull, fnNull, fnNull, fnNull},
+            {fnScanTime, fnScanTimeReset, fnBootTime, fnIsrToLoop, fnNull, fnNull, fnNull, fnNull}
         };
 
         int numBytes = smbus_has_numBytes_to_handle; // place value on stack so it will go away when done.